@@ -0,0 +1,160 @@
+#include "ADCFilter.h"
+
+namespace ESPtools {
+namespace ADC {
+
+MovingAverage::MovingAverage(uint8_t window)
+  : _window(constrain(window, 1, MAX_WINDOW)) {
+  reset();
+}
+
+void MovingAverage::reset() {
+  _sum = 0;
+  _pos = 0;
+  _filled = 0;
+}
+
+size_t MovingAverage::process(int32_t *data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (_filled == _window) _sum -= _history[_pos];
+    else                    ++_filled;
+    _history[_pos] = data[i];
+    _sum += data[i];
+    if (++_pos == _window) _pos = 0;
+    data[i] = int32_t(_sum / _filled);
+  }
+  return count;
+}
+
+MedianFilter::MedianFilter(uint8_t window, int32_t outlierThreshold)
+  : _threshold(outlierThreshold) {
+  window = constrain(window, 1, MAX_WINDOW);
+  _window = window | 1;
+  reset();
+}
+
+void MedianFilter::reset() {
+  _pos = 0;
+  _filled = 0;
+}
+
+size_t MedianFilter::process(int32_t *data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    int32_t in = data[i];
+
+    // Keep _sorted ordered: drop the sample leaving the window, insert the new one.
+    uint8_t n = _filled;
+    if (_filled == _window) {
+      int32_t old = _history[_pos];
+      uint8_t j = 0;
+      while (_sorted[j] != old) ++j;
+      for (; j + 1 < n; ++j) _sorted[j] = _sorted[j + 1];
+      --n;
+    } else {
+      ++_filled;
+    }
+    uint8_t j = n;
+    while (j > 0 && _sorted[j - 1] > in) {
+      _sorted[j] = _sorted[j - 1];
+      --j;
+    }
+    _sorted[j] = in;
+    _history[_pos] = in;
+    if (++_pos == _window) _pos = 0;
+
+    int32_t median = _sorted[_filled / 2];
+    if (_threshold > 0) {
+      int32_t dev = in - median;
+      data[i] = (dev > _threshold || dev < -_threshold) ? median : in;
+    } else {
+      data[i] = median;
+    }
+  }
+  return count;
+}
+
+CICDecimator::CICDecimator(uint8_t order, uint16_t ratio)
+  : _ratio(ratio ? ratio : 1),
+    _order(constrain(order, 1, MAX_ORDER)) {
+  _gain = 1;
+  for (uint8_t k = 0; k < _order; ++k) _gain *= _ratio;
+  reset();
+}
+
+void CICDecimator::reset() {
+  for (uint8_t k = 0; k < MAX_ORDER; ++k) {
+    _integrator[k] = 0;
+    _comb[k] = 0;
+  }
+  _phase = 0;
+}
+
+size_t CICDecimator::process(int32_t *data, size_t count) {
+  size_t out = 0;
+  for (size_t i = 0; i < count; ++i) {
+    // Integrators may wrap; the combs undo it, so use unsigned arithmetic.
+    uint64_t acc = uint64_t(int64_t(data[i]));
+    for (uint8_t k = 0; k < _order; ++k) {
+      acc = uint64_t(_integrator[k]) + acc;
+      _integrator[k] = int64_t(acc);
+    }
+    if (++_phase < _ratio) continue;
+    _phase = 0;
+
+    for (uint8_t k = 0; k < _order; ++k) {
+      uint64_t prev = uint64_t(_comb[k]);
+      _comb[k] = int64_t(acc);
+      acc -= prev;
+    }
+    int64_t y = int64_t(acc);
+    y = (y >= 0) ? (y + _gain / 2) / _gain : (y - _gain / 2) / _gain;
+    data[out++] = int32_t(y);
+  }
+  return out;
+}
+
+IIRFilter::IIRFilter(uint8_t shift)
+  : _shift(constrain(shift, 0, 16)) {
+  reset();
+}
+
+void IIRFilter::reset() {
+  _state = 0;
+  _primed = false;
+}
+
+size_t IIRFilter::process(int32_t *data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    int64_t x = int64_t(data[i]) << 16;
+    if (!_primed) {
+      _state = x;
+      _primed = true;
+    } else {
+      _state += (x - _state) >> _shift;
+    }
+    data[i] = int32_t((_state + (1 << 15)) >> 16);
+  }
+  return count;
+}
+
+FilterPipeline::FilterPipeline() : _count(0) {}
+
+bool FilterPipeline::add(FilterStage &stage) {
+  if (_count >= MAX_STAGES) return false;
+  _stages[_count++] = &stage;
+  return true;
+}
+
+size_t FilterPipeline::process(int32_t *data, size_t count) {
+  for (uint8_t i = 0; i < _count && count > 0; ++i) {
+    count = _stages[i]->process(data, count);
+  }
+  return count;
+}
+
+void FilterPipeline::reset() {
+  for (uint8_t i = 0; i < _count; ++i) _stages[i]->reset();
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef ESPTOOLS_ADCFILTER_H
+#define ESPTOOLS_ADCFILTER_H
+
+#include <Arduino.h>
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * One stage of a sample-block filter chain. Stages work in place on raw
+ * signed codes, keep their history across calls, and never allocate.
+ */
+class FilterStage {
+public:
+  virtual ~FilterStage() {}
+
+  /**
+   * Filter a block in place. Decimating stages return fewer samples.
+   * @param data  samples, overwritten with the output
+   * @param count number of input samples
+   * @return number of output samples at the start of data
+   */
+  virtual size_t process(int32_t *data, size_t count) = 0;
+
+  /**
+   * Clear history (e.g. after a channel or gain change).
+   */
+  virtual void reset() = 0;
+};
+
+/**
+ * Boxcar moving average over the last `window` samples.
+ */
+class MovingAverage : public FilterStage {
+public:
+  static constexpr uint8_t MAX_WINDOW = 64;
+
+  explicit MovingAverage(uint8_t window);
+  size_t process(int32_t *data, size_t count) override;
+  void reset() override;
+
+private:
+  int32_t _history[MAX_WINDOW];
+  int64_t _sum;
+  uint8_t _window, _pos, _filled;
+};
+
+/**
+ * Running median over an odd window. With a nonzero outlierThreshold the
+ * stage passes samples through and only replaces those further than the
+ * threshold (in codes) from the median.
+ */
+class MedianFilter : public FilterStage {
+public:
+  static constexpr uint8_t MAX_WINDOW = 15;
+
+  explicit MedianFilter(uint8_t window, int32_t outlierThreshold = 0);
+  size_t process(int32_t *data, size_t count) override;
+  void reset() override;
+
+private:
+  int32_t _history[MAX_WINDOW];
+  int32_t _sorted[MAX_WINDOW];
+  int32_t _threshold;
+  uint8_t _window, _pos, _filled;
+};
+
+/**
+ * Cascaded integrator-comb decimator (differential delay 1), normalised so
+ * a DC input comes out unchanged. Emits one sample per `ratio` inputs.
+ * order 1..4; ratio^order must stay below 2^40 to avoid overflow.
+ */
+class CICDecimator : public FilterStage {
+public:
+  static constexpr uint8_t MAX_ORDER = 4;
+
+  CICDecimator(uint8_t order, uint16_t ratio);
+  size_t process(int32_t *data, size_t count) override;
+  void reset() override;
+
+private:
+  int64_t  _integrator[MAX_ORDER];
+  int64_t  _comb[MAX_ORDER];
+  int64_t  _gain;
+  uint16_t _ratio, _phase;
+  uint8_t  _order;
+};
+
+/**
+ * Single-pole low-pass, y += (x - y) / 2^shift, kept in fixed point with
+ * 16 fractional bits so small steps are not lost to truncation.
+ */
+class IIRFilter : public FilterStage {
+public:
+  explicit IIRFilter(uint8_t shift);
+  size_t process(int32_t *data, size_t count) override;
+  void reset() override;
+
+private:
+  int64_t _state;
+  uint8_t _shift;
+  bool    _primed;
+};
+
+/**
+ * Ordered chain of filter stages applied to each block.
+ */
+class FilterPipeline {
+public:
+  static constexpr uint8_t MAX_STAGES = 8;
+
+  FilterPipeline();
+
+  /**
+   * Append a stage. The stage object must outlive the pipeline.
+   * @return false if the pipeline is full
+   */
+  bool add(FilterStage &stage);
+
+  /**
+   * Run all stages over data in place.
+   * @return number of output samples
+   */
+  size_t process(int32_t *data, size_t count);
+
+  void reset();
+
+private:
+  FilterStage *_stages[MAX_STAGES];
+  uint8_t      _count;
+};
+
+}
+}
+
+#endif
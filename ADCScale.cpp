@@ -0,0 +1,41 @@
+#include "ADCScale.h"
+
+namespace ESPtools {
+namespace ADC {
+
+Scale::Scale()
+  : _voltsPerCode(0.0f), _offset(0), _uvMul(0), _uvRound(0), _uvShift(0) {}
+
+Scale::Scale(float fullScaleVolts, int32_t fullScaleCode,
+             int32_t offsetCodes, float gainCorrection)
+  : _offset(offsetCodes) {
+  double voltsPerCode = double(fullScaleVolts) * gainCorrection / double(fullScaleCode);
+  _voltsPerCode = float(voltsPerCode);
+
+  // Largest Q-format shift that keeps the microvolt multiplier within int32.
+  double uvPerCode = voltsPerCode * 1e6;
+  uint8_t shift = 30;
+  while (shift > 0 && uvPerCode * double(1UL << shift) >= 2147483647.0) --shift;
+  _uvShift = shift;
+  _uvMul   = int32_t(uvPerCode * double(1UL << shift) + 0.5);
+  _uvRound = shift ? (int64_t(1) << (shift - 1)) : 0;
+}
+
+void Scale::toVolts(const int32_t *codes, float *volts, size_t count) const {
+  const float k = _voltsPerCode;
+  const int32_t off = _offset;
+  for (size_t i = 0; i < count; ++i) volts[i] = float(codes[i] - off) * k;
+}
+
+void Scale::toMicrovolts(const int32_t *codes, int32_t *microvolts, size_t count) const {
+  const int64_t mul = _uvMul;
+  const int64_t rnd = _uvRound;
+  const uint8_t sh  = _uvShift;
+  const int32_t off = _offset;
+  for (size_t i = 0; i < count; ++i) {
+    microvolts[i] = int32_t((int64_t(codes[i] - off) * mul + rnd) >> sh);
+  }
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef ESPTOOLS_ADCSCALE_H
+#define ESPTOOLS_ADCSCALE_H
+
+#include <Arduino.h>
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * Precomputed code-to-voltage conversion for one gain/reference/calibration
+ * combination, shared by the ADS1115 and ADS1256 drivers.
+ *
+ * Built once when the configuration changes; after that a conversion is a
+ * single float multiply, or a 64-bit multiply and shift for the fixed-point
+ * microvolt path. Block variants convert whole sample buffers in one pass.
+ */
+class Scale {
+public:
+  Scale();
+
+  /**
+   * @param fullScaleVolts input voltage that produces fullScaleCode
+   * @param fullScaleCode  code at +full scale (e.g. 0x7FFFFF, 32768)
+   * @param offsetCodes    calibration offset, subtracted from raw codes
+   * @param gainCorrection calibration gain factor (1.0 = none)
+   */
+  Scale(float fullScaleVolts, int32_t fullScaleCode,
+        int32_t offsetCodes = 0, float gainCorrection = 1.0f);
+
+  /**
+   * Convert one raw code to volts.
+   */
+  float toVolts(int32_t code) const {
+    return float(code - _offset) * _voltsPerCode;
+  }
+
+  /**
+   * Convert one raw code to microvolts (rounded, integer only).
+   */
+  int32_t toMicrovolts(int32_t code) const {
+    return int32_t((int64_t(code - _offset) * _uvMul + _uvRound) >> _uvShift);
+  }
+
+  /**
+   * Convert a block of raw codes to volts.
+   */
+  void toVolts(const int32_t *codes, float *volts, size_t count) const;
+
+  /**
+   * Convert a block of raw codes to microvolts. codes and microvolts may alias.
+   */
+  void toMicrovolts(const int32_t *codes, int32_t *microvolts, size_t count) const;
+
+  float voltsPerCode() const { return _voltsPerCode; }
+
+private:
+  float   _voltsPerCode;
+  int32_t _offset;
+  int32_t _uvMul;
+  int64_t _uvRound;
+  uint8_t _uvShift;
+};
+
+}
+}
+
+#endif
@@ -3,12 +3,32 @@
 namespace ESPtools {
 namespace ADC {
 
+constexpr float ADS1115::FSR_VOLTS[8];
+constexpr uint32_t ADS1115::CONVERSION_US[8];
+
 ADS1115::ADS1115(TwoWire &wire, uint8_t address, int8_t drdyPin)
-  : _wire(wire), _address(address), _drdyPin(drdyPin), _configReg(0x8583), _currentChannel(0) {}
+  : _wire(wire), _channel(nullptr), _address(address), _drdyPin(drdyPin), _configReg(0x8580),
+    _mux(0x04), _timeouts(0), _conversionReady(false) {
+  setCalibration(0, 1.0f);
+}
+
+ADS1115::ADS1115(Mux::PCA9548A::Channel &channel, uint8_t address, int8_t drdyPin)
+  : _wire(channel.wire()), _channel(&channel), _address(address), _drdyPin(drdyPin),
+    _configReg(0x8580), _mux(0x04), _timeouts(0), _conversionReady(false) {
+  setCalibration(0, 1.0f);
+}
 
 bool ADS1115::begin() {
   _wire.begin();
-  if (_drdyPin >= 0) pinMode(_drdyPin, INPUT);
+
+  // Hi_thresh MSB = 1 and Lo_thresh MSB = 0 turn ALERT/RDY into a
+  // conversion-ready output; COMP_QUE = 00 (in _configReg) enables it.
+  writeRegister(REG_HI_THRESH, 0x8000);
+  writeRegister(REG_LO_THRESH, 0x0000);
+  if (_drdyPin >= 0) {
+    pinMode(_drdyPin, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(_drdyPin), onAlert, this, FALLING);
+  }
 
   writeRegister(REG_CONFIG, _configReg);
   return true;
@@ -16,10 +36,9 @@ bool ADS1115::begin() {
 
 bool ADS1115::isReady() {
   if (_drdyPin >= 0) {
-    return digitalRead(_drdyPin) == LOW;
+    return _conversionReady || digitalRead(_drdyPin) == LOW;
   }
-  waitForConversion();
-  return true;
+  return readRegister(REG_CONFIG) & 0x8000;
 }
 
 void ADS1115::setGain(uint8_t gainCode) {
@@ -35,139 +54,165 @@ void ADS1115::setSampleRate(uint8_t rateCode) {
 }
 
 void ADS1115::setChannel(uint8_t channel) {
-  _currentChannel = channel & 0x03;
+  _mux = singleEnded(channel);
 }
 
 int32_t ADS1115::read(uint8_t samples) {
   int64_t total = 0;
+  uint8_t valid = 0;
   for (uint8_t i = 0; i < samples; ++i) {
 
-    uint16_t cfg = 0x8000;
-    cfg |= uint16_t(0x04 + _currentChannel) << 12;
-    cfg |= _configReg & 0x0F9F;
-    cfg |= _configReg & 0x00E0;
-    _configReg = cfg;
-    writeRegister(REG_CONFIG, _configReg);
-
-    waitForConversion();
+    // Single-shot on the selected MUX input, keeping gain, rate and comparator bits.
+    uint16_t cfg = 0x8000 | 0x0100;
+    cfg |= uint16_t(_mux) << 12;
+    cfg |= _configReg & 0x0EFF;
+    writeConfig(cfg);
+
+    if (!waitForConversion()) {
+      // The conversion register still holds the previous result.
+      ++_timeouts;
+      continue;
+    }
     uint16_t raw = readRegister(REG_CONVERSION);
     total += int16_t(raw);
+    ++valid;
   }
-  return total / samples;
+  return valid ? int32_t(total / valid) : 0;
 }
 
 float ADS1115::readVoltage(uint8_t channel, uint8_t samples) {
   setChannel(channel);
-  int32_t raw = read(samples);
-  float fsr;
-  switch ((_configReg >> 9) & 0x07) {
-    case ADS1115::GAIN_TWOTHIRDS: fsr = 6.144f; break;
-    case ADS1115::GAIN_1X:        fsr = 4.096f; break;
-    case ADS1115::GAIN_2X:        fsr = 2.048f; break;
-    case ADS1115::GAIN_4X:        fsr = 1.024f; break;
-    case ADS1115::GAIN_8X:        fsr = 0.512f; break;
-    case ADS1115::GAIN_16X:       fsr = 0.256f; break;
-    default:                      fsr = 4.096f; break;
-  }
-  return raw * fsr / 32768.0f;
+  return scale().toVolts(read(samples));
 }
 
-static uint8_t diffMuxCode(uint8_t p, uint8_t n) {
-  if (p == 0 && n == 1) return 0b000;
-  if (p == 0 && n == 3) return 0b001;
-  if (p == 1 && n == 3) return 0b010;
-  if (p == 2 && n == 3) return 0b011;
-  return 0xFF;
+int32_t ADS1115::readMicrovolts(uint8_t channel, uint8_t samples) {
+  setChannel(channel);
+  return scale().toMicrovolts(read(samples));
+}
+
+void ADS1115::setCalibration(int32_t offsetCodes, float gainCorrection) {
+  for (uint8_t g = 0; g < 8; ++g) {
+    _scales[g] = Scale(FSR_VOLTS[g], 32768, offsetCodes, gainCorrection);
+  }
 }
 
 void ADS1115::setDifferential(uint8_t posChannel, uint8_t negChannel) {
-  uint8_t code = diffMuxCode(posChannel, negChannel);
+  uint8_t code = differential(posChannel, negChannel);
   if (code == 0xFF) return;
+  _mux = code;
+}
 
-
-  uint8_t gainCode  = (_configReg >> 9) & 0x07;
-  uint8_t drateCode = (_configReg >> 5) & 0x07;
-
-  uint16_t cfg = 0x8000
-               | (uint16_t(code)     << 12)
-               | (uint16_t(gainCode) << 9)
-               | (1                   << 8)
-               | (uint16_t(drateCode)<< 5)
-               | (0                   << 4)
-               | 0;
-
-
-  Wire.beginTransmission(_address);
-  Wire.write(0x01);
-  Wire.write(uint8_t(cfg >> 8));
-  Wire.write(uint8_t(cfg & 0xFF));
-  Wire.endTransmission();
+int32_t ADS1115::readDifferential(uint8_t posChannel, uint8_t negChannel, uint8_t samples) {
+  if (differential(posChannel, negChannel) == 0xFF) return 0;
+  setDifferential(posChannel, negChannel);
+  return read(samples);
 }
 
 float ADS1115::readDifferentialVoltage(uint8_t posChannel,
                                        uint8_t negChannel,
                                        uint8_t samples) {
-  int32_t raw = readDifferential(posChannel, negChannel, samples);
-
-  uint8_t gainCode = (_configReg >> 9) & 0x07;
-  float   fsr;
-  switch (gainCode) {
-    case GAIN_TWOTHIRDS: fsr = 6.144f; break;
-    case GAIN_1X:        fsr = 4.096f; break;
-    case GAIN_2X:        fsr = 2.048f; break;
-    case GAIN_4X:        fsr = 1.024f; break;
-    case GAIN_8X:        fsr = 0.512f; break;
-    case GAIN_16X:       fsr = 0.256f; break;
-    default:             fsr = 4.096f; break;
-  }
+  return scale().toVolts(readDifferential(posChannel, negChannel, samples));
+}
 
-  return float(raw) * (fsr / 32768.0f);
+int32_t ADS1115::readDifferentialMicrovolts(uint8_t posChannel,
+                                            uint8_t negChannel,
+                                            uint8_t samples) {
+  return scale().toMicrovolts(readDifferential(posChannel, negChannel, samples));
 }
 
 uint8_t ADS1115::testI2C() {
+  Mux::PCA9548A::Guard guard(_channel);
+  BusStats::Probe probe(BusStats::I2C, _address, Mux::PCA9548A::route(_channel));
   _wire.beginTransmission(_address);
   _wire.write(REG_CONVERSION);
-  if (_wire.endTransmission() != 0) return 0;
-  _wire.requestFrom(int(_address), 1);
+  bool ok = _wire.endTransmission() == 0;
+  probe.transaction(1, ok);
+  if (!ok) return 0;
+  probe.transaction(1, _wire.requestFrom(int(_address), 1) == 1);
   return _wire.available() ? _wire.read() : 0;
 }
 
 void ADS1115::reset() {
-  _configReg = 0x8583;
+  _configReg = 0x8580;
   writeRegister(REG_CONFIG, _configReg);
 }
 
 
 void ADS1115::writeRegister(uint8_t reg, uint16_t value) {
+  Mux::PCA9548A::Guard guard(_channel);
+  BusStats::Probe probe(BusStats::I2C, _address, Mux::PCA9548A::route(_channel));
   _wire.beginTransmission(_address);
   _wire.write(reg);
   _wire.write(value >> 8);
   _wire.write(value & 0xFF);
-  _wire.endTransmission();
+  probe.transaction(3, _wire.endTransmission() == 0);
 }
 
 uint16_t ADS1115::readRegister(uint8_t reg) {
+  Mux::PCA9548A::Guard guard(_channel);
+  BusStats::Probe probe(BusStats::I2C, _address, Mux::PCA9548A::route(_channel));
   _wire.beginTransmission(_address);
   _wire.write(reg);
-  _wire.endTransmission();
-  _wire.requestFrom(int(_address), 2);
+  probe.transaction(1, _wire.endTransmission() == 0);
+  probe.transaction(2, _wire.requestFrom(int(_address), 2) == 2);
   uint16_t hi = _wire.read();
   uint16_t lo = _wire.read();
   return (hi << 8) | lo;
 }
 
-void ADS1115::waitForConversion() {
-  uint8_t dr = (_configReg >> 5) & 0x07;
-  switch (dr) {
-    case SPS_8:   delay(125); break;
-    case SPS_16:  delay(63);  break;
-    case SPS_32:  delay(32);  break;
-    case SPS_64:  delay(16);  break;
-    case SPS_128: delay(8);   break;
-    case SPS_250: delay(4);   break;
-    case SPS_475: delay(3);   break;
-    case SPS_860: delay(2);   break;
+void ADS1115::writeConfig(uint16_t config) {
+  _conversionReady = false;
+  _configReg = config;
+  writeRegister(REG_CONFIG, _configReg);
+}
+
+void ADS1115::startConversion(uint8_t mux, uint8_t gainCode, bool continuous) {
+  uint16_t cfg = 0x8000
+               | (uint16_t(mux & 0x07) << 12)
+               | (uint16_t(gainCode & 0x07) << 9)
+               | (_configReg & 0x00FF);
+  if (continuous) cfg &= ~0x0100;
+  else            cfg |= 0x0100;
+  writeConfig(cfg);
+}
+
+int16_t ADS1115::readConversion() {
+  _conversionReady = false;
+  return int16_t(readRegister(REG_CONVERSION));
+}
+
+void ADS1115::stopConversions() {
+  _configReg |= 0x0100;
+  writeRegister(REG_CONFIG, _configReg & 0x7FFF);
+}
+
+bool ADS1115::waitForConversion() {
+  uint32_t nominal = CONVERSION_US[(_configReg >> 5) & 0x07];
+  // The internal oscillator is specified to ±10%; give up after twice nominal.
+  uint32_t timeout = nominal * 2 + 1000;
+  unsigned long start = micros();
+
+  if (_drdyPin >= 0) {
+    while (!_conversionReady) {
+      if (micros() - start > timeout) return false;
+      yield();
+    }
+    return true;
   }
+
+  // No ALERT/RDY wired: sleep through most of the conversion, then poll OS.
+  uint32_t idle = nominal - nominal / 10;
+  if (idle >= 1000) delay(idle / 1000);
+  delayMicroseconds(idle % 1000);
+  while (!(readRegister(REG_CONFIG) & 0x8000)) {
+    if (micros() - start > timeout) return false;
+    delayMicroseconds(nominal / 32);
+  }
+  return true;
+}
+
+void IRAM_ATTR ADS1115::onAlert(void *arg) {
+  static_cast<ADS1115 *>(arg)->_conversionReady = true;
 }
 
 }
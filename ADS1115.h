@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "ADCScale.h"
+#include "BusStats.h"
+#include "PCA9548A.h"
 
 namespace ESPtools {
 namespace ADC {
@@ -50,6 +53,11 @@ public:
   static constexpr uint8_t SPS_16  = 1;
   static constexpr uint8_t SPS_8   = 0;
 
+  // Full-scale range in volts per gain code (codes 6-7 alias ±0.256V).
+  static constexpr float FSR_VOLTS[8] = {
+    6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f
+  };
+
   /**
    * Constructor: configure I2C bus and optional alert pin.
    * @param wire    TwoWire instance (e.g., Wire)
@@ -58,13 +66,23 @@ public:
    */
   ADS1115(TwoWire &wire = Wire, uint8_t address = 0x48, int8_t drdyPin = -1);
 
+  /**
+   * Constructor for a device behind a PCA9548A; the mux is switched
+   * automatically on every access.
+   * @param channel downstream bus proxy from PCA9548A::channel()
+   */
+  ADS1115(Mux::PCA9548A::Channel &channel, uint8_t address = 0x48, int8_t drdyPin = -1);
+
   /**
    * Initialize I2C, apply default gain/rate, return true on success.
+   * Programs Hi_thresh/Lo_thresh for conversion-ready mode so ALERT/RDY
+   * signals the end of every conversion; attaches its interrupt if wired.
    */
   bool begin();
 
   /**
-   * Check if conversion ready. If drdyPin < 0, always return true after wait.
+   * Check if conversion ready without blocking. Uses the ALERT/RDY pin if
+   * wired, otherwise reads the OS bit of the config register.
    */
   bool isReady();
 
@@ -84,7 +102,9 @@ public:
   void setChannel(uint8_t channel);
 
   /**
-   * Read raw ADC value, averaging n conversions.
+   * Read raw ADC value, averaging n conversions. Conversions that time out
+   * are left out of the average and counted in timeoutCount().
+   * @return average code, or 0 if every conversion timed out
    */
   int32_t read(uint8_t samples = 1);
 
@@ -92,6 +112,11 @@ public:
    * Read voltage (volts) on given channel, averaging samples.
    */
   float readVoltage(uint8_t channel, uint8_t samples = 1);
+
+  /**
+   * Read channel in microvolts (integer path), averaging samples.
+   */
+  int32_t readMicrovolts(uint8_t channel, uint8_t samples = 1);
   
   /**
    * Configure internal MUX for a P-N differential channel.
@@ -110,6 +135,28 @@ public:
    */
   float readDifferentialVoltage(uint8_t posChannel, uint8_t negChannel, uint8_t samples = 50);
 
+  /**
+   * Read differential input in microvolts.
+   */
+  int32_t readDifferentialMicrovolts(uint8_t posChannel, uint8_t negChannel, uint8_t samples = 50);
+
+  /**
+   * Apply a two-point calibration to all voltage conversions.
+   * @param offsetCodes    raw code measured with shorted inputs
+   * @param gainCorrection actual/measured ratio at a reference voltage
+   */
+  void setCalibration(int32_t offsetCodes, float gainCorrection = 1.0f);
+
+  /**
+   * Code-to-voltage conversion for the current gain.
+   */
+  const Scale &scale() const { return _scales[(_configReg >> 9) & 0x07]; }
+
+  /**
+   * Code-to-voltage conversion for a specific gain code.
+   */
+  const Scale &scale(uint8_t gainCode) const { return _scales[gainCode & 0x07]; }
+
   /**
    * Read device ID (returns I2C address, since ADS1115 has no ID reg).
    */
@@ -125,19 +172,84 @@ public:
    */
   void reset();
 
+  /**
+   * MUX code (Config bits [14:12]) for single-ended input AINx vs GND.
+   */
+  static constexpr uint8_t singleEnded(uint8_t channel) {
+    return uint8_t(0x04 + (channel & 0x03));
+  }
+
+  /**
+   * MUX code for a differential pair, or 0xFF if the pair is unsupported.
+   */
+  static constexpr uint8_t differential(uint8_t posChannel, uint8_t negChannel) {
+    return (posChannel == 0 && negChannel == 1) ? 0x00
+         : (posChannel == 0 && negChannel == 3) ? 0x01
+         : (posChannel == 1 && negChannel == 3) ? 0x02
+         : (posChannel == 2 && negChannel == 3) ? 0x03
+         : 0xFF;
+  }
+
+  /**
+   * Start a conversion without waiting for it. Keeps the configured data
+   * rate; the gain given here becomes the current gain.
+   * @param mux        MUX code (singleEnded() / differential())
+   * @param gainCode   PGA gain (use GAIN_ constants)
+   * @param continuous true for continuous-conversion mode
+   */
+  void startConversion(uint8_t mux, uint8_t gainCode, bool continuous = false);
+
+  /**
+   * Read the conversion register and clear the ready flag. Non-blocking;
+   * pair with isReady().
+   */
+  int16_t readConversion();
+
+  /**
+   * Leave continuous mode (device powers down after the current conversion).
+   */
+  void stopConversions();
+
+  /**
+   * Nominal conversion time at the current data rate, microseconds.
+   */
+  uint32_t conversionMicros() const { return CONVERSION_US[(_configReg >> 5) & 0x07]; }
+
+  bool hasReadyPin() const { return _drdyPin >= 0; }
+
+  /**
+   * Conversions in read() that did not finish within twice their nominal
+   * time, since construction.
+   */
+  uint32_t timeoutCount() const { return _timeouts; }
+
 private:
   TwoWire &_wire;
+  Mux::PCA9548A::Channel *_channel;
   uint8_t  _address;
   int8_t   _drdyPin;
   uint16_t _configReg;
-  uint8_t  _currentChannel;
+  uint8_t  _mux;
+  Scale    _scales[8];
+  uint32_t _timeouts;
 
   static constexpr uint8_t REG_CONVERSION = 0x00;
   static constexpr uint8_t REG_CONFIG     = 0x01;
+  static constexpr uint8_t REG_LO_THRESH  = 0x02;
+  static constexpr uint8_t REG_HI_THRESH  = 0x03;
+
+  // Nominal conversion time per data-rate code, microseconds.
+  static constexpr uint32_t CONVERSION_US[8] = {
+    125000, 62500, 31250, 15625, 7813, 4000, 2106, 1163
+  };
+
+  volatile bool _conversionReady;
 
   void writeRegister(uint8_t reg, uint16_t value);
   uint16_t readRegister(uint8_t reg);
-  void waitForConversion();
+  void writeConfig(uint16_t config);
+  bool waitForConversion();
+  static void onAlert(void *arg);
 };
 
 }
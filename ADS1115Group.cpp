@@ -0,0 +1,151 @@
+#include "ADS1115Group.h"
+
+namespace ESPtools {
+namespace ADC {
+
+ADS1115Group::ADS1115Group()
+  : _count(0), _steps(0), _step(0), _running(false), _failed(false), _timeouts(0) {}
+
+int8_t ADS1115Group::addDevice(ADS1115 &adc, Mux::PCA9548A *mux, uint8_t bus) {
+  if (_count >= MAX_DEVICES) return -1;
+  Device &d = _devices[_count];
+  d.adc = &adc;
+  d.mux = mux;
+  d.bus = bus & 0x07;
+  d.inputs = 0;
+  d.pending = false;
+  d.timedOut = false;
+  d.validMask = 0;
+  return int8_t(_count++);
+}
+
+bool ADS1115Group::addInput(uint8_t device, uint8_t mux, uint8_t gainCode) {
+  if (device >= _count || mux > 0x07) return false;
+  Device &d = _devices[device];
+  if (d.inputs >= MAX_INPUTS) return false;
+  d.muxCode[d.inputs] = mux;
+  d.gain[d.inputs]    = gainCode & 0x07;
+  d.results[d.inputs] = 0;
+  ++d.inputs;
+  if (d.inputs > _steps) _steps = d.inputs;
+  return true;
+}
+
+bool ADS1115Group::sample(uint32_t *sweepMicros) {
+  unsigned long t0 = micros();
+  if (!start()) return false;
+  while (!poll()) yield();
+  if (sweepMicros) *sweepMicros = micros() - t0;
+  return !_failed;
+}
+
+bool ADS1115Group::start() {
+  if (_steps == 0) return false;
+  _step = 0;
+  _failed = false;
+  _running = true;
+  for (uint8_t i = 0; i < _count; ++i) _devices[i].validMask = 0;
+  startStep();
+  return true;
+}
+
+bool ADS1115Group::poll() {
+  if (!_running) return false;
+  if (!stepDone()) return false;
+  collectStep();
+  if (++_step < _steps) {
+    startStep();
+    return false;
+  }
+  _running = false;
+  return true;
+}
+
+int16_t ADS1115Group::result(uint8_t device, uint8_t input) const {
+  if (device >= _count || input >= _devices[device].inputs) return 0;
+  return _devices[device].results[input];
+}
+
+bool ADS1115Group::valid(uint8_t device, uint8_t input) const {
+  if (device >= _count || input >= _devices[device].inputs) return false;
+  return _devices[device].validMask & (1 << input);
+}
+
+float ADS1115Group::voltage(uint8_t device, uint8_t input) const {
+  if (device >= _count || input >= _devices[device].inputs) return 0.0f;
+  const Device &d = _devices[device];
+  return d.adc->scale(d.gain[input]).toVolts(d.results[input]);
+}
+
+int32_t ADS1115Group::microvolts(uint8_t device, uint8_t input) const {
+  if (device >= _count || input >= _devices[device].inputs) return 0;
+  const Device &d = _devices[device];
+  return d.adc->scale(d.gain[input]).toMicrovolts(d.results[input]);
+}
+
+void ADS1115Group::select(const Device &d) {
+  if (d.mux) d.mux->selectBus(d.bus);
+}
+
+void ADS1115Group::startStep() {
+  for (uint8_t i = 0; i < _count; ++i) {
+    Device &d = _devices[i];
+    d.pending = _step < d.inputs;
+    d.timedOut = false;
+    if (!d.pending) continue;
+    select(d);
+    d.adc->startConversion(d.muxCode[_step], d.gain[_step]);
+    d.started = micros();
+  }
+}
+
+bool ADS1115Group::stepDone() {
+  bool done = true;
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < _count; ++i) {
+    Device &d = _devices[i];
+    if (!d.pending) continue;
+
+    uint32_t nominal = d.adc->conversionMicros();
+    uint32_t elapsed = now - d.started;
+    bool ready;
+    if (d.adc->hasReadyPin()) {
+      ready = d.adc->isReady();
+    } else if (elapsed < nominal) {
+      // Not worth an I2C read before the nominal conversion time.
+      ready = false;
+    } else {
+      select(d);
+      ready = d.adc->isReady();
+    }
+
+    if (!ready && elapsed > nominal * 2 + 1000) {
+      ++_timeouts;
+      _failed = true;
+      d.timedOut = true;
+      ready = true;
+    }
+    if (ready) d.pending = false;
+    else       done = false;
+  }
+  return done;
+}
+
+void ADS1115Group::collectStep() {
+  // Reverse order: the mux bus selected last by startStep() is served first.
+  for (uint8_t i = _count; i-- > 0;) {
+    Device &d = _devices[i];
+    if (_step >= d.inputs) continue;
+    if (d.timedOut) {
+      // The conversion register still holds an older result.
+      d.results[_step] = 0;
+      continue;
+    }
+    select(d);
+    d.results[_step] = d.adc->readConversion();
+    d.validMask |= 1 << _step;
+  }
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef ESPTOOLS_ADS1115GROUP_H
+#define ESPTOOLS_ADS1115GROUP_H
+
+#include <Arduino.h>
+#include "ADS1115.h"
+#include "PCA9548A.h"
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * Overlapped conversions across several ADS1115s on one I2C bus.
+ *
+ * Each sweep step starts a conversion on every device first, then waits
+ * once and collects all results, so N devices cost one conversion time
+ * per step instead of N. Devices may sit behind a PCA9548A; the group
+ * selects the downstream bus before each access (skipping the write when
+ * it is already selected), so identical addresses on different mux
+ * channels are fine.
+ *
+ * Each device has its own input list; step k converts input k on every
+ * device that has one. Devices must already be begun and set to the
+ * wanted data rate.
+ */
+class ADS1115Group {
+public:
+  static constexpr uint8_t MAX_DEVICES = 16;
+  static constexpr uint8_t MAX_INPUTS  = 4;
+
+  ADS1115Group();
+
+  /**
+   * Add a device to the group.
+   * @param adc   ADS1115 driver
+   * @param mux   PCA9548A the device sits behind, or nullptr
+   * @param bus   downstream bus on that PCA9548A (0-7)
+   * @return device index, or -1 if the group is full
+   */
+  int8_t addDevice(ADS1115 &adc, Mux::PCA9548A *mux = nullptr, uint8_t bus = 0);
+
+  /**
+   * Append an input to a device's list.
+   * @param device   index from addDevice()
+   * @param mux      MUX code (ADS1115::singleEnded() / differential())
+   * @param gainCode PGA gain (use ADS1115::GAIN_ constants)
+   */
+  bool addInput(uint8_t device, uint8_t mux, uint8_t gainCode);
+
+  /**
+   * Run one full sweep, blocking until every input has a result.
+   * @param sweepMicros optional, receives the sweep duration
+   * @return false if any conversion timed out
+   */
+  bool sample(uint32_t *sweepMicros = nullptr);
+
+  /**
+   * Begin a sweep without waiting. Drive it with poll().
+   */
+  bool start();
+
+  /**
+   * Advance a running sweep: collect finished steps, start the next.
+   * @return true once the sweep is complete
+   */
+  bool poll();
+
+  bool isRunning() const { return _running; }
+
+  /**
+   * Raw result of a device input from the last sweep; 0 if its conversion
+   * timed out (see valid()).
+   */
+  int16_t result(uint8_t device, uint8_t input) const;
+
+  /**
+   * True if a device input completed in the last sweep.
+   */
+  bool valid(uint8_t device, uint8_t input) const;
+
+  /**
+   * Result of a device input in volts, using that input's gain.
+   */
+  float voltage(uint8_t device, uint8_t input) const;
+
+  /**
+   * Result of a device input in microvolts, using that input's gain.
+   */
+  int32_t microvolts(uint8_t device, uint8_t input) const;
+
+  /**
+   * Conversions that did not finish within twice their nominal time.
+   */
+  uint32_t timeoutCount() const { return _timeouts; }
+
+  uint8_t deviceCount() const { return _count; }
+
+private:
+  struct Device {
+    ADS1115       *adc;
+    Mux::PCA9548A *mux;
+    uint8_t        bus;
+    uint8_t        inputs;
+    uint8_t        muxCode[MAX_INPUTS];
+    uint8_t        gain[MAX_INPUTS];
+    int16_t        results[MAX_INPUTS];
+    uint32_t       started;
+    bool           pending;
+    bool           timedOut;  // current step
+    uint8_t        validMask; // inputs completed in the last sweep
+  };
+
+  Device   _devices[MAX_DEVICES];
+  uint8_t  _count;
+  uint8_t  _steps;
+  uint8_t  _step;
+  bool     _running;
+  bool     _failed;
+  uint32_t _timeouts;
+
+  void select(const Device &d);
+  void startStep();
+  bool stepDone();
+  void collectStep();
+};
+
+}
+}
+
+#endif
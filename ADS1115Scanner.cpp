@@ -0,0 +1,95 @@
+#include "ADS1115Scanner.h"
+
+namespace ESPtools {
+namespace ADC {
+
+ADS1115Scanner::ADS1115Scanner(ADS1115 &adc)
+  : _adc(adc), _count(0), _current(0), _running(false), _continuous(false),
+    _started(0), _overflows(0), _sweeps(0) {}
+
+int8_t ADS1115Scanner::addInput(uint8_t mux, uint8_t gainCode) {
+  if (_count >= MAX_INPUTS || mux > 0x07) return -1;
+  _mux[_count]    = mux;
+  _gain[_count]   = gainCode & 0x07;
+  _latest[_count] = 0;
+  return int8_t(_count++);
+}
+
+void ADS1115Scanner::clear() {
+  stop();
+  _count = 0;
+}
+
+bool ADS1115Scanner::start() {
+  if (_count == 0) return false;
+  _running = true;
+  _sweeps = 0;
+  startInput(0);
+  return true;
+}
+
+void ADS1115Scanner::stop() {
+  if (_running && _continuous) _adc.stopConversions();
+  _running = false;
+  _continuous = false;
+}
+
+bool ADS1115Scanner::poll() {
+  if (!_running) return false;
+  uint32_t now = micros();
+  if (!conversionDone(now)) return false;
+
+  ADS1115Reading r;
+  r.input     = _current;
+  r.mux       = _mux[_current];
+  r.gain      = _gain[_current];
+  r.raw       = _adc.readConversion();
+  r.timestamp = now;
+  _latest[_current] = r.raw;
+
+  // Start the next conversion before handing the result out, so the ADC
+  // is already busy while the handler runs.
+  uint8_t next = _current + 1;
+  if (next >= _count) {
+    next = 0;
+    ++_sweeps;
+  }
+  if (_continuous && _mux[next] == r.mux && _gain[next] == r.gain) {
+    _current = next;
+    _started = now;
+  } else {
+    startInput(next);
+  }
+
+  if (!_buffer.push(r)) ++_overflows;
+  if (_handler) _handler(r);
+  return true;
+}
+
+bool ADS1115Scanner::sameAsNext(uint8_t index) const {
+  uint8_t next = (index + 1 < _count) ? index + 1 : 0;
+  return _mux[next] == _mux[index] && _gain[next] == _gain[index];
+}
+
+void ADS1115Scanner::startInput(uint8_t index) {
+  _current = index;
+  _continuous = sameAsNext(index);
+  _adc.startConversion(_mux[index], _gain[index], _continuous);
+  _started = micros();
+}
+
+bool ADS1115Scanner::conversionDone(uint32_t now) {
+  if (_adc.hasReadyPin()) return _adc.isReady();
+
+  // No ALERT/RDY: nothing can be ready before the nominal conversion time.
+  uint32_t nominal = _adc.conversionMicros();
+  if (_continuous) {
+    // OS reads busy in continuous mode; allow for the ±10% oscillator instead.
+    return now - _started >= nominal + nominal / 10;
+  }
+  if (now - _started < nominal) return false;
+  return _adc.isReady();
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef ESPTOOLS_ADS1115SCANNER_H
+#define ESPTOOLS_ADS1115SCANNER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "ADS1115.h"
+#include "RingBuffer.h"
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * One completed ADS1115 conversion from a scan list.
+ */
+struct ADS1115Reading {
+  uint8_t  input;      // index in the scan list
+  uint8_t  mux;        // MUX code the conversion used
+  uint8_t  gain;       // PGA gain code the conversion used
+  int16_t  raw;        // signed conversion result
+  uint32_t timestamp;  // micros() when the result was collected
+};
+
+/**
+ * Non-blocking round-robin scanner for one ADS1115.
+ *
+ * Cycles through a list of single-ended/differential inputs, each with its
+ * own gain. Call poll() from loop() or a task: it never waits, it only
+ * collects a finished conversion and starts the next one. Runs of identical
+ * consecutive entries (or a single-entry list) use continuous mode so no
+ * config write is needed between samples.
+ *
+ * Completion is detected from the ALERT/RDY interrupt when wired, otherwise
+ * from elapsed time and the OS bit, so no I2C traffic is spent polling early.
+ * Readings go to a handler and/or an internal buffer.
+ */
+class ADS1115Scanner {
+public:
+  static constexpr uint8_t MAX_INPUTS  = 8;
+  static constexpr size_t  BUFFER_SIZE = 64;
+
+  using ReadingHandler = std::function<void(const ADS1115Reading &)>;
+
+  explicit ADS1115Scanner(ADS1115 &adc);
+
+  /**
+   * Append an input to the scan list.
+   * @param mux      MUX code (ADS1115::singleEnded() / differential())
+   * @param gainCode PGA gain (use ADS1115::GAIN_ constants)
+   * @return index of the input, or -1 if the list is full or mux invalid
+   */
+  int8_t addInput(uint8_t mux, uint8_t gainCode);
+
+  /**
+   * Remove all inputs (stops the scanner).
+   */
+  void clear();
+
+  /**
+   * Called from poll() for every completed reading.
+   */
+  void onReading(ReadingHandler handler) { _handler = handler; }
+
+  /**
+   * Start the first conversion. Returns false if the list is empty.
+   */
+  bool start();
+
+  /**
+   * Stop scanning and take the device out of continuous mode.
+   */
+  void stop();
+
+  bool isRunning() const { return _running; }
+
+  /**
+   * Collect a finished conversion, if any, and start the next one.
+   * @return true if a reading was produced
+   */
+  bool poll();
+
+  /**
+   * Buffered readings not yet taken with read().
+   */
+  size_t available() const { return _buffer.available(); }
+
+  /**
+   * Take the oldest buffered reading.
+   */
+  bool read(ADS1115Reading &reading) { return _buffer.pop(reading); }
+
+  /**
+   * Readings dropped because the buffer was full.
+   */
+  uint32_t overflowCount() const { return _overflows; }
+
+  /**
+   * Number of complete passes over the scan list.
+   */
+  uint32_t sweepCount() const { return _sweeps; }
+
+  /**
+   * Most recent raw result for an input.
+   */
+  int16_t latest(uint8_t input) const { return input < _count ? _latest[input] : 0; }
+
+  float toVolts(const ADS1115Reading &reading) const {
+    return _adc.scale(reading.gain).toVolts(reading.raw);
+  }
+
+  int32_t toMicrovolts(const ADS1115Reading &reading) const {
+    return _adc.scale(reading.gain).toMicrovolts(reading.raw);
+  }
+
+private:
+  ADS1115 &_adc;
+  uint8_t  _mux[MAX_INPUTS];
+  uint8_t  _gain[MAX_INPUTS];
+  int16_t  _latest[MAX_INPUTS];
+  uint8_t  _count;
+  uint8_t  _current;
+  bool     _running;
+  bool     _continuous;
+  uint32_t _started;
+  uint32_t _overflows;
+  uint32_t _sweeps;
+  ReadingHandler _handler;
+  Util::RingBuffer<ADS1115Reading, BUFFER_SIZE> _buffer;
+
+  bool sameAsNext(uint8_t index) const;
+  void startInput(uint8_t index);
+  bool conversionDone(uint32_t now);
+};
+
+}
+}
+
+#endif
@@ -3,44 +3,134 @@
 namespace ESPtools {
 namespace ADC {
 
+constexpr float ADS1256::PGA_FACTORS[8];
+constexpr uint32_t ADS1256::SPI_CLOCK;
+constexpr uint32_t ADS1256::RESET_TIMEOUT_MS;
+constexpr uint32_t ADS1256::CAL_TIMEOUT_MS;
+
 ADS1256::ADS1256(SPIClass &spi, int8_t csPin, int8_t drdyPin, int8_t rstPin)
-  : _spi(spi),
+  : _spi(spi, csPin, SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE1)),
     _csPin(csPin),
     _drdyPin(drdyPin),
-    _rstPin(rstPin)
+    _rstPin(rstPin),
+    _known(0),
+    _dirty(0),
+    _batchDepth(0),
+    _streaming(false),
+    _overflows(0),
+    _initState(InitState::Idle),
+    _initSince(0)
 {
 
   _config.gain             = 0;
-  _config.drateCode        = 0x06;
+  _config.drateCode        = SPS_30000;
   _config.referenceVoltage = 2.5f;
-  _config.commandSpeed     = 1000000UL;
-  _config.readSpeed        = 1000000UL;
-  _config.idSpeed          = 1000000UL;
-  _config.testSpeed        = 1000000UL;
-  _config.spiMode          = SPI_MODE1;
+  _config.offsetCodes      = 0;
+  _config.gainCorrection   = 1.0f;
+  updateScales();
+
+  // Datasheet power-on values; not trusted until written or read back.
+  _regs[REG_STATUS] = 0x30;
+  _regs[REG_MUX]    = 0x01;
+  _regs[REG_ADCON]  = 0x20;
+  _regs[REG_DRATE]  = 0xF0;
 }
 
 bool ADS1256::begin() {
-  pinMode(_csPin, OUTPUT);
+  beginAsync();
+  while (!pollBegin()) yield();
+  return isInitialized();
+}
+
+void ADS1256::beginAsync() {
+  if (!_spi.begin()) {
+    _initState = InitState::Failed;
+    return;
+  }
   if (_drdyPin >= 0) pinMode(_drdyPin, INPUT);
-  pinMode(_rstPin, OUTPUT);
-  digitalWrite(_csPin, HIGH);
-  digitalWrite(_rstPin, HIGH);
-  delay(100);
-
-  reset(); delay(10);
-  setGain(_config.gain); setSampleRate(_config.drateCode);
-  uint8_t adcon = readRegister(0x02);
-  adcon |= (1<<3);
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x50 | 0x02);
-  _spi.transfer(0x00);
-  _spi.transfer(adcon);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction();
-  delay(10);
-  selfCalibrate(); delay(50);
+  if (_rstPin >= 0) {
+    pinMode(_rstPin, OUTPUT);
+    digitalWrite(_rstPin, HIGH);
+  }
+  startReset();
+  _initState = InitState::Reset;
+  _initSince = millis();
+}
+
+bool ADS1256::pollBegin() {
+  switch (_initState) {
+    case InitState::Reset:
+      if (dataReady()) {
+        syncRegisters();
+        configure();
+        sendCommand(0xF0);
+        _initState = InitState::Calibrate;
+        _initSince = millis();
+      } else if (millis() - _initSince > RESET_TIMEOUT_MS) {
+        _initState = InitState::Failed;
+      }
+      return false;
+    case InitState::Calibrate:
+      if (dataReady()) {
+        _initState = InitState::Ready;
+      } else if (millis() - _initSince > CAL_TIMEOUT_MS) {
+        _initState = InitState::Failed;
+      }
+      return _initState != InitState::Calibrate;
+    default:
+      return true;
+  }
+}
+
+bool ADS1256::beginAll(ADS1256 *const *adcs, uint8_t count) {
+  for (uint8_t i = 0; i < count; ++i) adcs[i]->beginAsync();
+  bool pending = true;
+  while (pending) {
+    pending = false;
+    for (uint8_t i = 0; i < count; ++i) {
+      if (!adcs[i]->pollBegin()) pending = true;
+    }
+    if (pending) yield();
+  }
+  bool ok = true;
+  for (uint8_t i = 0; i < count; ++i) ok = ok && adcs[i]->isInitialized();
+  return ok;
+}
+
+void ADS1256::startReset() {
+  // The device restarts with the datasheet defaults.
+  _known = 0;
+  _dirty = 0;
+  if (_rstPin >= 0) {
+    // RST low for at least 4 CLKIN periods; DRDY stays high until ready.
+    digitalWrite(_rstPin, LOW);
+    delayMicroseconds(2);
+    digitalWrite(_rstPin, HIGH);
+  } else {
+    sendCommand(0xFE);
+  }
+}
+
+void ADS1256::configure() {
+  beginBatch();
+  setGain(_config.gain);
+  setSampleRate(_config.drateCode);
+  stageRegister(REG_ADCON, _regs[REG_ADCON] | (1<<3));
+  commit();
+}
+
+bool ADS1256::dataReady() {
+  if (_drdyPin >= 0) return digitalRead(_drdyPin) == LOW;
+  // STATUS bit 0 mirrors DRDY.
+  return !(readRegister(REG_STATUS) & 0x01);
+}
+
+bool ADS1256::waitReady(uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (!dataReady()) {
+    if (millis() - start > timeoutMs) return false;
+    delayMicroseconds(10);
+  }
   return true;
 }
 
@@ -50,35 +140,16 @@ bool ADS1256::isReady() {
 
 void ADS1256::setGain(uint8_t gainCode) {
   _config.gain = gainCode & 0x07;
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x52);
-  _spi.transfer(0x00);
-  _spi.transfer(_config.gain);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction(); delay(10);
+  stageRegister(REG_ADCON, (_regs[REG_ADCON] & 0xF8) | _config.gain);
 }
 
 void ADS1256::setSampleRate(uint8_t drateCode) {
   _config.drateCode = drateCode;
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x53);
-  _spi.transfer(0x00);
-  _spi.transfer(_config.drateCode);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction(); delay(10);
+  stageRegister(REG_DRATE, _config.drateCode);
 }
 
 void ADS1256::setChannel(uint8_t channel) {
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x51);
-  _spi.transfer(0x00);
-  _spi.transfer((channel << 4) | 0x08);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction(); delayMicroseconds(10);
-  sendCommand(0xFC); sendCommand(0x00); delayMicroseconds(10);
+  stageRegister(REG_MUX, singleEnded(channel));
 }
 
 int32_t ADS1256::read(uint8_t samples) {
@@ -90,60 +161,81 @@ int32_t ADS1256::read(uint8_t samples) {
       delayMicroseconds(10);
     }
 
-    _spi.beginTransaction(SPISettings(_config.readSpeed, MSBFIRST, _config.spiMode));
-    digitalWrite(_csPin, LOW);
-    _spi.transfer(0x01);
-    delayMicroseconds(10);
-
+    total += readConversion();
+    delayMicroseconds(100);
+  }
 
-    uint32_t raw24 = ((uint32_t)_spi.transfer(0) << 16)
-                   | ((uint32_t)_spi.transfer(0) << 8)
-                   |  (uint32_t)_spi.transfer(0);
-    digitalWrite(_csPin, HIGH);
-    _spi.endTransaction();
 
+  return (int32_t)(total / samples);
+}
 
-    if (raw24 & 0x800000) {
-      raw24 |= 0xFF000000;
-    }
-    int32_t signed24 = (int32_t)raw24;
+int32_t ADS1256::readConversion() {
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  uint8_t buf[3] = { 0, 0, 0 };
+  _spi.select();
+  _spi.transfer(0x01);
+  delayMicroseconds(7);
+  _spi.transferBytes(buf, buf, 3);
+  _spi.deselect();
+  probe.transaction(4);
+  uint32_t raw24 = ((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8) | buf[2];
+
+  if (raw24 & 0x800000) raw24 |= 0xFF000000;
+  return (int32_t)raw24;
+}
 
-    total += signed24;
-    delayMicroseconds(100);
-  }
+void ADS1256::startConversion(uint8_t mux, uint8_t gainCode) {
+  beginBatch();
+  stageRegister(REG_MUX, mux);
+  setGain(gainCode);
+  // flushRegisters() only restarts the filter when MUX/ADCON/DRATE changed
+  // (a STATUS-only write does not); rewriting MUX forces the SYNC/WAKEUP
+  // into the same CS window.
+  if (!(_dirty & RESTART_MASK)) _dirty |= 1 << REG_MUX;
+  commit();
+}
 
+void ADS1256::prepareConversion(uint8_t mux, uint8_t gainCode) {
+  ++_batchDepth;
+  stageRegister(REG_MUX, mux);
+  setGain(gainCode);
+  --_batchDepth;
+  if (!(_dirty & RESTART_MASK)) _dirty |= 1 << REG_MUX;
+  flushRegisters(false);
+}
 
-  return (int32_t)(total / samples);
+void ADS1256::wakeup() {
+  // No trailing delay: group members are woken back to back.
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(1);
+  _spi.select(); _spi.transfer(0x00); _spi.deselect();
 }
 
 float ADS1256::readVoltage(uint8_t channel, uint8_t samples) {
   setChannel(channel);
-  int32_t signedRaw = read(samples);
-
-  float vref   = _config.referenceVoltage;
-  float fsMax  = float((1 << 23) - 1);
+  return scale().toVolts(read(samples));
+}
 
-  float pga    = PGA_FACTORS[_config.gain];
+int32_t ADS1256::readMicrovolts(uint8_t channel, uint8_t samples) {
+  setChannel(channel);
+  return scale().toMicrovolts(read(samples));
+}
 
+void ADS1256::setCalibration(int32_t offsetCodes, float gainCorrection) {
+  _config.offsetCodes    = offsetCodes;
+  _config.gainCorrection = gainCorrection;
+  updateScales();
+}
 
-  return (float(signedRaw) / fsMax) * (vref / pga);
+void ADS1256::updateScales() {
+  for (uint8_t g = 0; g < 8; ++g) {
+    _scales[g] = Scale(_config.referenceVoltage / PGA_FACTORS[g], (1L << 23) - 1,
+                       _config.offsetCodes, _config.gainCorrection);
+  }
 }
 
 void ADS1256::setDifferential(uint8_t posChannel, uint8_t negChannel) {
-  const uint8_t MUX = 0x01;
-  uint8_t value = ((posChannel & 0x07) << 4) | (negChannel & 0x07);
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x50 | MUX);
-  _spi.transfer(0x00);
-  _spi.transfer(value);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction();
-  delayMicroseconds(10);
-
-  sendCommand(0xFC);
-  sendCommand(0x00);
-  delayMicroseconds(10);
+  stageRegister(REG_MUX, differential(posChannel, negChannel));
 }
 
 int32_t ADS1256::readDifferential(uint8_t posChannel, uint8_t negChannel, uint8_t samples) {
@@ -154,51 +246,283 @@ int32_t ADS1256::readDifferential(uint8_t posChannel, uint8_t negChannel, uint8_
 float ADS1256::readDifferentialVoltage(uint8_t posChannel,
                                        uint8_t negChannel,
                                        uint8_t samples) {
-  int32_t signedRaw = readDifferential(posChannel, negChannel, samples);
-  float    full     = float((1 << 23) - 1);
-  float    pga      = float(1 << _config.gain);
-  float    vref     = _config.referenceVoltage;
+  return scale().toVolts(readDifferential(posChannel, negChannel, samples));
+}
 
-  return (float(signedRaw) / full) * (vref / pga);
+int32_t ADS1256::readDifferentialMicrovolts(uint8_t posChannel,
+                                            uint8_t negChannel,
+                                            uint8_t samples) {
+  return scale().toMicrovolts(readDifferential(posChannel, negChannel, samples));
 }
 
 uint8_t ADS1256::readID() {
-  _spi.beginTransaction(SPISettings(_config.idSpeed, MSBFIRST, _config.spiMode)); digitalWrite(_csPin, LOW);
-  _spi.transfer(0x20); _spi.transfer(0); delayMicroseconds(10);
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(3);
+  static const uint8_t cmd[2] = { 0x20, 0x00 };
+  _spi.select(); _spi.write(cmd, 2); delayMicroseconds(7);
   uint8_t id=_spi.transfer(0);
-  digitalWrite(_csPin, HIGH); _spi.endTransaction(); return id;
+  _spi.deselect(); return id;
 }
 
 uint8_t ADS1256::testSPI() {
-  _spi.beginTransaction(SPISettings(_config.testSpeed, MSBFIRST, _config.spiMode)); digitalWrite(_csPin, LOW);
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(1);
+  _spi.select();
   uint8_t r = _spi.transfer(0xFF);
-  digitalWrite(_csPin, HIGH); _spi.endTransaction(); return r;
+  _spi.deselect(); return r;
 }
 
-void ADS1256::reset() {
-  digitalWrite(_rstPin, LOW); delay(10); digitalWrite(_rstPin, HIGH); delay(10);
-  sendCommand(0xFE); delay(10);
+bool ADS1256::reset() {
+  startReset();
+  bool ok = waitReady(RESET_TIMEOUT_MS);
+  syncRegisters();
+  // The reset restored the datasheet defaults; put the configured gain and
+  // data rate back.
+  if (ok) configure();
+  return ok;
 }
 
-void ADS1256::selfCalibrate() { sendCommand(0xF0); }
+bool ADS1256::selfCalibrate() {
+  sendCommand(0xF0);
+  return waitReady(CAL_TIMEOUT_MS);
+}
 
 void ADS1256::sendCommand(uint8_t cmd) {
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW); _spi.transfer(cmd); digitalWrite(_csPin, HIGH);
-  _spi.endTransaction(); delayMicroseconds(10);
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(1);
+  _spi.select(); _spi.transfer(cmd); _spi.deselect();
+  delayMicroseconds(10);
 }
 
 uint8_t ADS1256::readRegister(uint8_t reg) {
+  uint8_t val = 0;
+  readRegisters(reg, &val, 1);
+  return val;
+}
 
-  _spi.beginTransaction(SPISettings(_config.commandSpeed, MSBFIRST, _config.spiMode));
-  digitalWrite(_csPin, LOW);
-  _spi.transfer(0x10 | (reg & 0x0F));
-  _spi.transfer(0x00);
+bool ADS1256::waitForDRDY(uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (digitalRead(_drdyPin) == HIGH) {
+    if (millis() - start > timeoutMs) return false;
+  }
+  return true;
+}
+
+bool ADS1256::startStreaming() {
+  if (_drdyPin < 0 || _streaming) return false;
+  _stream.clear();
+  _overflows = 0;
+
+  // RDATAC is issued right after DRDY falls; the ISR picks up from the next word.
+  // Data words read by the ISR are not counted in BusStats.
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  _spi.select();
+  if (!waitForDRDY(1000)) {
+    _spi.deselect();
+    return false;
+  }
+  _spi.transfer(0x03);
+  probe.transaction(1);
   delayMicroseconds(10);
-  uint8_t val = _spi.transfer(0x00);
-  digitalWrite(_csPin, HIGH);
-  _spi.endTransaction();
-  return val;
+
+  _streaming = true;
+  attachInterruptArg(digitalPinToInterrupt(_drdyPin), onDataReady, this, FALLING);
+  return true;
+}
+
+void ADS1256::stopStreaming() {
+  if (!_streaming) return;
+  detachInterrupt(digitalPinToInterrupt(_drdyPin));
+  _streaming = false;
+
+  // SDATAC must not overlap a data word, so send it in a DRDY-low window.
+  waitForDRDY(1000);
+  _spi.transfer(0x0F);
+  _spi.deselect();
+  delayMicroseconds(10);
+}
+
+size_t ADS1256::readBlock(int32_t *dst, size_t maxSamples) {
+  return _stream.read(dst, maxSamples);
+}
+
+void ADS1256::startScan(uint8_t firstMux) {
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(5);
+  const uint8_t wreg[3] = { 0x51, 0x00, firstMux };
+  _spi.select();
+  _spi.write(wreg, 3);
+  _regs[REG_MUX] = firstMux;
+  _known |= (1 << REG_MUX);
+  _spi.transfer(0xFC);
+  delayMicroseconds(4);
+  _spi.transfer(0x00);
+  _spi.deselect();
+}
+
+bool ADS1256::scanCycle(uint8_t nextMux, int32_t &previous) {
+  if (!waitForDRDY(1000)) return false;
+
+  // One CS window: queue the next input, restart the filter on it, then
+  // read out the result that was latched for the previous input.
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(9);
+  const uint8_t wreg[3] = { 0x51, 0x00, nextMux };
+  uint8_t buf[3] = { 0, 0, 0 };
+  _spi.select();
+  _spi.write(wreg, 3);
+  _regs[REG_MUX] = nextMux;
+  _spi.transfer(0xFC);
+  delayMicroseconds(4);
+  _spi.transfer(0x00);
+  _spi.transfer(0x01);
+  delayMicroseconds(7);
+  _spi.transferBytes(buf, buf, 3);
+  _spi.deselect();
+  uint32_t raw24 = ((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8) | buf[2];
+
+  if (raw24 & 0x800000) raw24 |= 0xFF000000;
+  previous = (int32_t)raw24;
+  return true;
+}
+
+bool ADS1256::scanSweep(const uint8_t *muxList, uint8_t count, int32_t *results,
+                        uint32_t &sweepMicros) {
+  Util::SPIDevice::Burst burst(_spi);
+  unsigned long start = micros();
+  for (uint8_t i = 0; i < count; ++i) {
+    uint8_t next = muxList[(i + 1) < count ? i + 1 : 0];
+    if (!scanCycle(next, results[i])) return false;
+  }
+  sweepMicros = micros() - start;
+  return true;
+}
+
+bool ADS1256::scan(const uint8_t *muxList, uint8_t count, int32_t *results,
+                   uint32_t *sweepMicros) {
+  if (_drdyPin < 0 || _streaming || count == 0) return false;
+  uint32_t elapsed = 0;
+  Util::SPIDevice::Burst burst(_spi);
+  startScan(muxList[0]);
+  if (!scanSweep(muxList, count, results, elapsed)) return false;
+  if (sweepMicros) *sweepMicros = elapsed;
+  return true;
+}
+
+uint32_t ADS1256::scanContinuous(const uint8_t *muxList, uint8_t count,
+                                 ScanHandler handler, uint32_t maxSweeps) {
+  if (_drdyPin < 0 || _streaming || count == 0 || count > SCAN_MAX_ENTRIES) return 0;
+  int32_t results[SCAN_MAX_ENTRIES];
+  uint32_t sweeps = 0;
+  startScan(muxList[0]);
+  while (maxSweeps == 0 || sweeps < maxSweeps) {
+    uint32_t elapsed = 0;
+    if (!scanSweep(muxList, count, results, elapsed)) break;
+    ++sweeps;
+    if (!handler(results, count, elapsed)) break;
+  }
+  return sweeps;
+}
+
+void IRAM_ATTR ADS1256::onDataReady(void *arg) {
+  ADS1256 *self = static_cast<ADS1256 *>(arg);
+  uint8_t buf[3] = { 0, 0, 0 };
+#if defined(ARDUINO_ARCH_ESP32)
+  // Bus lock is already held by startStreaming(); use the no-lock HAL call.
+  spiTransferBytesNL(self->_spi.spi().bus(), buf, buf, 3);
+#else
+  self->_spi.spi().transfer(buf, 3);
+#endif
+  uint32_t raw24 = ((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8) | buf[2];
+  if (raw24 & 0x800000) raw24 |= 0xFF000000;
+  if (!self->_stream.push((int32_t)raw24)) self->_overflows = self->_overflows + 1;
+}
+
+void ADS1256::readRegisters(uint8_t startReg, uint8_t *values, uint8_t count) {
+  if (count == 0) return;
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(2 + count);
+  const uint8_t cmd[2] = { uint8_t(0x10 | (startReg & 0x0F)), uint8_t((count - 1) & 0x0F) };
+  memset(values, 0, count);
+  _spi.select();
+  _spi.write(cmd, 2);
+  delayMicroseconds(7);
+  _spi.transferBytes(values, values, count);
+  _spi.deselect();
+}
+
+void ADS1256::writeRegisters(uint8_t startReg, const uint8_t *values, uint8_t count) {
+  if (count == 0) return;
+  if (count > 16) count = 16;
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(2 + count);
+  uint8_t frame[2 + 16];
+  frame[0] = 0x50 | (startReg & 0x0F);
+  frame[1] = (count - 1) & 0x0F;
+  memcpy(frame + 2, values, count);
+  _spi.select();
+  _spi.write(frame, 2 + count);
+  _spi.deselect();
+}
+
+void ADS1256::beginBatch() {
+  ++_batchDepth;
+}
+
+void ADS1256::commit() {
+  if (_batchDepth > 0 && --_batchDepth > 0) return;
+  flushRegisters();
+}
+
+void ADS1256::syncRegisters() {
+  readRegisters(REG_STATUS, _regs, CACHED_REGS);
+  _known = (1 << CACHED_REGS) - 1;
+  _dirty = 0;
+}
+
+void ADS1256::stageRegister(uint8_t reg, uint8_t value) {
+  if ((_known & (1 << reg)) && _regs[reg] == value && !(_dirty & (1 << reg))) return;
+  _regs[reg] = value;
+  _dirty |= (1 << reg);
+  if (_batchDepth == 0) flushRegisters();
+}
+
+void ADS1256::flushRegisters(bool wakeup) {
+  if (!_dirty) return;
+  // One WREG per run of dirty registers. A run may span clean registers
+  // whose value is known (rewritten from the cache) but never an unknown
+  // one, so registers that were never read or written keep their contents.
+  uint8_t writable = _dirty | _known;
+  uint8_t frame[3 * CACHED_REGS];
+  uint8_t length = 0;
+  for (uint8_t reg = 0; reg < CACHED_REGS; ++reg) {
+    if (!(_dirty & (1 << reg))) continue;
+    uint8_t first = reg;
+    for (uint8_t next = reg + 1; next < CACHED_REGS && (writable & (1 << next)); ++next) {
+      if (_dirty & (1 << next)) reg = next;
+    }
+    frame[length++] = 0x50 | first;
+    frame[length++] = reg - first;
+    memcpy(frame + length, _regs + first, reg - first + 1);
+    length += reg - first + 1;
+  }
+  bool restart = _dirty & RESTART_MASK;
+  BusStats::Probe probe(BusStats::SPI, _csPin);
+  probe.transaction(length + (restart ? (wakeup ? 2 : 1) : 0));
+
+  _spi.select();
+  _spi.write(frame, length);
+  if (restart) {
+    _spi.transfer(0xFC);
+    if (wakeup) {
+      delayMicroseconds(4);
+      _spi.transfer(0x00);
+    }
+  }
+  _spi.deselect();
+
+  _known |= _dirty;
+  _dirty = 0;
 }
 
 uint8_t ADS1256::readADCON() {
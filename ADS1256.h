@@ -3,6 +3,11 @@
 
 #include <Arduino.h>
 #include <SPI.h>
+#include <functional>
+#include "RingBuffer.h"
+#include "ADCScale.h"
+#include "BusStats.h"
+#include "SPIDevice.h"
 
 namespace ESPtools {
 namespace ADC {
@@ -75,6 +80,7 @@ public:
   	16.0f,  // code 4 ×16
   	32.0f,  // code 5 x32
   	64.0f,  // code 6 ×64
+  	64.0f,  // code 7 ×64
 };
 
 
@@ -87,12 +93,44 @@ public:
    */
   ADS1256(SPIClass &spi, int8_t csPin, int8_t drdyPin, int8_t rstPin);
 
+  /**
+   * Default SCLK; the datasheet limit is fCLKIN / 4 (1.92 MHz at 7.68 MHz).
+   */
+  static constexpr uint32_t SPI_CLOCK = 1000000UL;
+
   /**
    * Initialize ADS1256 hardware. Set pin modes, reset, apply default gain/rate,
-   * and self-calibrate. Returns true on success.
+   * and self-calibrate. Each step waits for the device to report ready
+   * (DRDY, or the STATUS register without a DRDY pin) instead of a fixed
+   * delay. Safe to call again to re-initialize after a fault.
+   * @return false if the device did not become ready in time
    */
   bool begin();
 
+  /**
+   * Start begin() without waiting: reset the device and return. Drive the
+   * rest of the sequence with pollBegin().
+   */
+  void beginAsync();
+
+  /**
+   * Advance an initialization started by beginAsync().
+   * @return true once it has finished, successfully or not
+   */
+  bool pollBegin();
+
+  /**
+   * True after a successful begin() / pollBegin() sequence.
+   */
+  bool isInitialized() const { return _initState == InitState::Ready; }
+
+  /**
+   * Initialize several devices concurrently, so resets and calibrations
+   * overlap instead of running one after another.
+   * @return true if every device became ready
+   */
+  static bool beginAll(ADS1256 *const *adcs, uint8_t count);
+
   /**
    * Check DRDY pin for data-ready (LOW). If drdyPin < 0, always returns true.
    */
@@ -100,18 +138,21 @@ public:
 
   /**
    * Set PGA gain code (use GAIN_ constants).
+   * Skipped if the cached ADCON value already matches.
    * @param gainCode 3-bit gain value (0x00-0x06)
    */
   void setGain(uint8_t gainCode);
 
   /**
    * Set data rate code (use SPS_ constants).
+   * Skipped if the cached DRATE value already matches.
    * @param drateCode 8-bit DRATE register value
    */
   void setSampleRate(uint8_t drateCode);
 
   /**
    * Select input channel for conversion (0-7).
+   * Restarts conversion (SYNC/WAKEUP) only if the MUX value changes.
    * @param channel Channel number
    */
   void setChannel(uint8_t channel);
@@ -130,6 +171,11 @@ public:
    * @return Measured voltage
    */
   float readVoltage(uint8_t channel, uint8_t samples = 50);
+
+  /**
+   * Read voltage on channel in microvolts (integer path), averaging samples.
+   */
+  int32_t readMicrovolts(uint8_t channel, uint8_t samples = 50);
   
   /**
    * Configure P-N differential conversion.
@@ -151,6 +197,13 @@ public:
                                 uint8_t negChannel,
                                 uint8_t samples = 50);
 
+  /**
+   * Read a differential conversion (microvolts).
+   */
+  int32_t readDifferentialMicrovolts(uint8_t posChannel,
+                                     uint8_t negChannel,
+                                     uint8_t samples = 50);
+
   /**
    * Read device ID register. Returns ID byte.
    */
@@ -162,26 +215,78 @@ public:
   uint8_t testSPI();
 
   /**
-   * Perform hardware reset sequence and sync.
+   * Reset the device (RST pin if wired, RESET command otherwise), wait
+   * until it is ready, reload the register cache and reapply the configured
+   * gain and data rate. Calibration is not rerun; call selfCalibrate().
+   * @return false if it did not become ready in time (nothing is reapplied)
    */
-  void reset();
+  bool reset();
 
   /**
-   * Perform self-calibration (calls SELFCAL command).
+   * Perform self-calibration (SELFCAL) and wait until it completes.
+   * @return false if it did not complete in time
    */
-  void selfCalibrate();
+  bool selfCalibrate();
   
   /**
   * Set reference voltage (default 2.5 V).
   */
   void setReferenceVoltage(float vref) {
   _config.referenceVoltage = vref;
+  updateScales();
   }
 
+  /**
+   * Apply a two-point calibration to all voltage conversions.
+   * @param offsetCodes    raw code measured with shorted inputs
+   * @param gainCorrection actual/measured ratio at a reference voltage
+   */
+  void setCalibration(int32_t offsetCodes, float gainCorrection = 1.0f);
+
+  /**
+   * Code-to-voltage conversion for the current gain. Use it to convert
+   * streamed or scanned sample blocks in one pass.
+   */
+  const Scale &scale() const { return _scales[_config.gain]; }
+
+  /**
+   * Code-to-voltage conversion for a specific gain code.
+   */
+  const Scale &scale(uint8_t gainCode) const { return _scales[gainCode & 0x07]; }
+
   /**
    * Read back a register for debugging.
    */
   uint8_t readRegister(uint8_t reg);
+
+  /**
+   * Read count consecutive registers with a single RREG.
+   */
+  void readRegisters(uint8_t startReg, uint8_t *values, uint8_t count);
+
+  /**
+   * Write count consecutive registers with a single WREG.
+   * Bypasses the register cache; use syncRegisters() afterwards if needed.
+   */
+  void writeRegisters(uint8_t startReg, const uint8_t *values, uint8_t count);
+
+  /**
+   * Defer register writes from setGain/setSampleRate/setChannel/
+   * setDifferential until commit(). Calls may nest.
+   */
+  void beginBatch();
+
+  /**
+   * Write all changed STATUS/MUX/ADCON/DRATE values in one multi-register
+   * WREG, followed by SYNC/WAKEUP if the conversion setup changed.
+   * Ends one beginBatch() level; does nothing until the outermost one.
+   */
+  void commit();
+
+  /**
+   * Reload the STATUS/MUX/ADCON/DRATE cache from the device.
+   */
+  void syncRegisters();
   
   // Quick method to read ADCON register.
   uint8_t readADCON();
@@ -190,21 +295,188 @@ public:
    * Send a single SPI command byte.
    */
   void sendCommand(uint8_t cmd);
-  
+
+  // Samples held between DRDY interrupts and readBlock() (power of two).
+  static constexpr size_t STREAM_BUFFER_SIZE = 1024;
+
+  /**
+   * Start continuous conversion streaming (RDATAC) on the current channel.
+   * Each DRDY falling edge clocks one 24-bit word into the stream buffer
+   * from interrupt context. Requires a DRDY pin. The SPI bus and CS stay
+   * claimed until stopStreaming(), which must be called from the same task;
+   * do not issue other commands meanwhile.
+   * @return false if no DRDY pin is set or already streaming
+   */
+  bool startStreaming();
+
+  /**
+   * Stop streaming (SDATAC) and release the SPI bus.
+   * Samples already buffered remain readable.
+   */
+  void stopStreaming();
+
+  bool isStreaming() const { return _streaming; }
+
+  /**
+   * Number of streamed samples waiting to be read.
+   */
+  size_t available() const { return _stream.available(); }
+
+  /**
+   * Drain streamed samples (signed 24-bit codes) into dst.
+   * @param dst        destination buffer
+   * @param maxSamples capacity of dst
+   * @return number of samples copied
+   */
+  size_t readBlock(int32_t *dst, size_t maxSamples);
+
+  /**
+   * Samples dropped because the stream buffer was full.
+   */
+  uint32_t overflowCount() const { return _overflows; }
+
+  /**
+   * MUX register value for single-ended input AINx against AINCOM.
+   */
+  static constexpr uint8_t singleEnded(uint8_t channel) {
+    return uint8_t(((channel & 0x07) << 4) | 0x08);
+  }
+
+  /**
+   * MUX register value for a P-N differential pair.
+   */
+  static constexpr uint8_t differential(uint8_t posChannel, uint8_t negChannel) {
+    return uint8_t(((posChannel & 0x07) << 4) | (negChannel & 0x07));
+  }
+
+  /**
+   * Convert each entry of a scan list once, using the datasheet cycling
+   * sequence: on DRDY, write the next MUX value, SYNC, WAKEUP, then RDATA
+   * the conversion that just finished. Requires a DRDY pin. The SPI bus is
+   * held for the whole sweep.
+   * @param muxList     MUX values (singleEnded() / differential())
+   * @param count       number of entries
+   * @param results     receives one signed 24-bit code per entry
+   * @param sweepMicros optional, receives the sweep duration
+   * @return false on DRDY timeout, missing DRDY pin, or while streaming
+   */
+  bool scan(const uint8_t *muxList, uint8_t count, int32_t *results,
+            uint32_t *sweepMicros = nullptr);
+
+  /**
+   * Called after every sweep of scanContinuous(). Return false to stop.
+   */
+  using ScanHandler = std::function<bool(const int32_t *results, uint8_t count,
+                                         uint32_t sweepMicros)>;
+
+  /**
+   * Run back-to-back sweeps of a scan list; the pipeline stays primed
+   * between sweeps so no conversion is wasted at sweep boundaries.
+   * @param muxList   MUX values
+   * @param count     number of entries (max SCAN_MAX_ENTRIES)
+   * @param handler   receives each completed sweep
+   * @param maxSweeps stop after this many sweeps (0 = until handler stops)
+   * @return number of completed sweeps
+   */
+  uint32_t scanContinuous(const uint8_t *muxList, uint8_t count,
+                          ScanHandler handler, uint32_t maxSweeps = 0);
+
+  static constexpr uint8_t SCAN_MAX_ENTRIES = 16;
+
+  /**
+   * Apply a MUX value and gain and restart the digital filter (SYNC/WAKEUP)
+   * in one CS window, even if neither changed, so the next DRDY delivers a
+   * settled conversion of whatever is on the inputs now. Does not wait.
+   * @param mux      MUX value (singleEnded() / differential())
+   * @param gainCode PGA gain (use GAIN_ constants)
+   */
+  void startConversion(uint8_t mux, uint8_t gainCode);
+
+  /**
+   * Like startConversion(), but leave the filter halted after SYNC until
+   * wakeup() (or the SYNC/PDWN pin) starts it. Not deferred by beginBatch().
+   */
+  void prepareConversion(uint8_t mux, uint8_t gainCode);
+
+  /**
+   * Send WAKEUP alone: start conversions after SYNC.
+   */
+  void wakeup();
+
+  /**
+   * Read the latest conversion (RDATA) without waiting for DRDY.
+   * @return signed 24-bit code
+   */
+  int32_t readConversion();
+
+  bool hasReadyPin() const { return _drdyPin >= 0; }
+
+  /**
+   * Change the SCLK used for every command (SPI mode 1, MSB first).
+   */
+  void setSPIClock(uint32_t hz) { _spi.setSettings(SPISettings(hz, MSBFIRST, SPI_MODE1)); }
+
+  /**
+   * The chip's handle on the shared bus. Hold an Util::SPIDevice::Burst on
+   * it to run several calls back to back without releasing the bus.
+   */
+  Util::SPIDevice &spiDevice() { return _spi; }
+
 private:
-  SPIClass &_spi;
+  Util::SPIDevice _spi;
   int8_t _csPin, _drdyPin, _rstPin;
   struct Config {
-    uint32_t commandSpeed;
-    uint32_t readSpeed;
-    uint32_t idSpeed;
-    uint32_t testSpeed;
-    uint8_t  spiMode;
     uint8_t  gain;
     uint8_t  drateCode;
     float    referenceVoltage;
+    int32_t  offsetCodes;
+    float    gainCorrection;
   } _config;
 
+  // One precomputed conversion per PGA code, rebuilt when vref/calibration change.
+  Scale _scales[8];
+  void updateScales();
+
+  static constexpr uint8_t REG_STATUS = 0x00;
+  static constexpr uint8_t REG_MUX    = 0x01;
+  static constexpr uint8_t REG_ADCON  = 0x02;
+  static constexpr uint8_t REG_DRATE  = 0x03;
+  static constexpr uint8_t CACHED_REGS = 4;
+  // Registers whose write must be followed by SYNC/WAKEUP.
+  static constexpr uint8_t RESTART_MASK = (1 << REG_MUX) | (1 << REG_ADCON) | (1 << REG_DRATE);
+
+  // Shadow of STATUS/MUX/ADCON/DRATE; bit n of _known/_dirty = register n.
+  uint8_t _regs[CACHED_REGS];
+  uint8_t _known;
+  uint8_t _dirty;
+  uint8_t _batchDepth;
+
+  Util::RingBuffer<int32_t, STREAM_BUFFER_SIZE> _stream;
+  volatile bool     _streaming;
+  volatile uint32_t _overflows;
+
+  enum class InitState : uint8_t { Idle, Reset, Calibrate, Ready, Failed };
+  InitState     _initState;
+  unsigned long _initSince;
+
+  // Time allowed for the device to come out of reset, and for SELFCAL
+  // (about 0.5 s at 2.5 SPS, PGA 1).
+  static constexpr uint32_t RESET_TIMEOUT_MS = 100;
+  static constexpr uint32_t CAL_TIMEOUT_MS   = 1000;
+
+  bool waitForDRDY(uint32_t timeoutMs);
+  bool dataReady();
+  bool waitReady(uint32_t timeoutMs);
+  void startReset();
+  void configure();
+  void stageRegister(uint8_t reg, uint8_t value);
+  void flushRegisters(bool wakeup = true);
+  void startScan(uint8_t firstMux);
+  bool scanCycle(uint8_t nextMux, int32_t &previous);
+  bool scanSweep(const uint8_t *muxList, uint8_t count, int32_t *results,
+                 uint32_t &sweepMicros);
+  static void onDataReady(void *arg);
+
 };
 
 }
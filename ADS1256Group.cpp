@@ -0,0 +1,98 @@
+#include "ADS1256Group.h"
+
+namespace ESPtools {
+namespace ADC {
+
+constexpr uint8_t ADS1256Group::MAX_DEVICES;
+
+ADS1256Group::ADS1256Group()
+  : _count(0), _syncPin(-1), _syncSkew(0), _spread(0), _timeouts(0) {}
+
+void ADS1256Group::setSyncPin(int8_t pin) {
+  _syncPin = pin;
+  if (_syncPin < 0) return;
+  pinMode(_syncPin, OUTPUT);
+  digitalWrite(_syncPin, HIGH);
+}
+
+int8_t ADS1256Group::addDevice(ADS1256 &adc, uint8_t mux, uint8_t gainCode) {
+  if (_count >= MAX_DEVICES || !adc.hasReadyPin()) return -1;
+  Device &d = _devices[_count];
+  d.adc  = &adc;
+  d.mux  = mux;
+  d.gain = gainCode & 0x07;
+  return int8_t(_count++);
+}
+
+bool ADS1256Group::start() {
+  if (_count == 0) return false;
+
+  if (_syncPin >= 0) {
+    for (uint8_t i = 0; i < _count; ++i) {
+      _devices[i].adc->startConversion(_devices[i].mux, _devices[i].gain);
+    }
+    // A short low pulse (>= 4 CLKIN periods, well under the 20 DRDY periods
+    // that would power down) restarts every filter on the rising edge.
+    digitalWrite(_syncPin, LOW);
+    delayMicroseconds(2);
+    digitalWrite(_syncPin, HIGH);
+    _syncSkew = 0;
+    return true;
+  }
+
+  for (uint8_t i = 0; i < _count; ++i) {
+    _devices[i].adc->prepareConversion(_devices[i].mux, _devices[i].gain);
+  }
+  unsigned long first = 0;
+  for (uint8_t i = 0; i < _count; ++i) {
+    _devices[i].adc->wakeup();
+    if (i == 0) first = micros();
+  }
+  _syncSkew = micros() - first;
+  return true;
+}
+
+bool ADS1256Group::readFrame(int32_t *frame, uint32_t *timestamp) {
+  if (_count == 0) return false;
+  const uint8_t all = uint8_t((1u << _count) - 1);
+  uint8_t ready = 0;
+  unsigned long start = millis();
+  unsigned long firstSeen = 0;
+  while (ready != all) {
+    for (uint8_t i = 0; i < _count; ++i) {
+      uint8_t bit = uint8_t(1u << i);
+      if ((ready & bit) || !_devices[i].adc->isReady()) continue;
+      if (!ready) firstSeen = micros();
+      ready |= bit;
+    }
+    if (ready == all) break;
+    if (millis() - start > 1000) {
+      ++_timeouts;
+      return false;
+    }
+    yield();
+  }
+  unsigned long now = micros();
+  _spread = now - firstSeen;
+
+  for (uint8_t i = 0; i < _count; ++i) frame[i] = _devices[i].adc->readConversion();
+  if (timestamp) *timestamp = now;
+  return true;
+}
+
+uint32_t ADS1256Group::capture(int32_t *buffer, uint32_t frames, uint32_t *timestamps) {
+  for (uint32_t f = 0; f < frames; ++f) {
+    if (!readFrame(buffer + f * _count, timestamps ? timestamps + f : nullptr)) return f;
+  }
+  return frames;
+}
+
+const Scale &ADS1256Group::scale(uint8_t device) const {
+  static const Scale none;
+  if (_count == 0) return none;
+  const Device &d = _devices[device < _count ? device : 0];
+  return d.adc->scale(d.gain);
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef ESPTOOLS_ADS1256GROUP_H
+#define ESPTOOLS_ADS1256GROUP_H
+
+#include <Arduino.h>
+#include "ADS1256.h"
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * Simultaneous sampling across several ADS1256s.
+ *
+ * start() configures each device's input and restarts all digital filters
+ * together: with a shared SYNC/PDWN pin by one low pulse on it, otherwise
+ * by halting every device with SYNC and then sending WAKEUP to each back to
+ * back. From then on the converters run in lock step, and each frame holds
+ * one conversion per device, read after all DRDY lines have fallen.
+ *
+ * Lock step only holds if the devices share one CLKIN and data rate; with
+ * separate crystals they drift apart and start() must be repeated. Reading
+ * a frame costs one RDATA per device, which bounds the usable data rate.
+ * Devices must already be begun, set to the same data rate, and have a
+ * DRDY pin.
+ */
+class ADS1256Group {
+public:
+  static constexpr uint8_t MAX_DEVICES = 8;
+
+  ADS1256Group();
+
+  /**
+   * Use a SYNC/PDWN line wired to every device for start(). The pin is
+   * driven HIGH from here on.
+   * @param pin GPIO, or -1 to synchronize with SPI commands
+   */
+  void setSyncPin(int8_t pin);
+
+  /**
+   * Add a device to the group. Its position in each frame follows the
+   * order of the calls.
+   * @param adc      ADS1256 driver
+   * @param mux      MUX value (ADS1256::singleEnded() / differential())
+   * @param gainCode PGA gain (use ADS1256::GAIN_ constants)
+   * @return device index, or -1 if the group is full or the ADC has no DRDY
+   */
+  int8_t addDevice(ADS1256 &adc, uint8_t mux, uint8_t gainCode);
+
+  /**
+   * Apply every device's input and gain and restart all conversions
+   * together. The first frame is ready one settling time later.
+   */
+  bool start();
+
+  /**
+   * Wait until every device has a new conversion and read them.
+   * @param frame     receives one signed 24-bit code per device
+   * @param timestamp optional, micros() when the last DRDY was seen
+   * @return false on DRDY timeout
+   */
+  bool readFrame(int32_t *frame, uint32_t *timestamp = nullptr);
+
+  /**
+   * Fill an interleaved buffer: frame f occupies
+   * buffer[f * deviceCount()] .. buffer[f * deviceCount() + deviceCount() - 1].
+   * @param buffer     room for frames * deviceCount() codes
+   * @param frames     number of frames
+   * @param timestamps optional, one entry per frame
+   * @return number of frames captured
+   */
+  uint32_t capture(int32_t *buffer, uint32_t frames, uint32_t *timestamps = nullptr);
+
+  /**
+   * Code-to-voltage conversion for a device's configured gain; a default
+   * Scale while the group is empty.
+   */
+  const Scale &scale(uint8_t device) const;
+
+  /**
+   * Time between the first and last WAKEUP in the last start(); 0 when a
+   * sync pin is used.
+   */
+  uint32_t syncSkewMicros() const { return _syncSkew; }
+
+  /**
+   * Time between the first and last DRDY fall seen for the last frame, as
+   * resolved by polling. Grows if the devices drift apart.
+   */
+  uint32_t frameSpreadMicros() const { return _spread; }
+
+  /**
+   * Frames that timed out waiting for DRDY, since construction.
+   */
+  uint32_t timeoutCount() const { return _timeouts; }
+
+  uint8_t deviceCount() const { return _count; }
+
+private:
+  struct Device {
+    ADS1256 *adc;
+    uint8_t  mux;
+    uint8_t  gain;
+  };
+
+  Device   _devices[MAX_DEVICES];
+  uint8_t  _count;
+  int8_t   _syncPin;
+  uint32_t _syncSkew;
+  uint32_t _spread;
+  uint32_t _timeouts;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "BusStats.h"
+#include "EventBus.h"
+#include "Mutex.h"
+
+namespace ESPtools {
+namespace BusStats {
+
+#if ESPTOOLS_BUS_STATS
+
+static DeviceStats devices[MAX_DEVICES];
+static uint8_t deviceTotal = 0;
+static Util::Mutex statsLock;
+
+static DeviceStats *search(Bus bus, uint8_t address, uint8_t route) {
+  for (uint8_t i = 0; i < deviceTotal; ++i) {
+    const DeviceStats &d = devices[i];
+    if (d.bus == bus && d.address == address && d.route == route) return &devices[i];
+  }
+  return nullptr;
+}
+
+static DeviceStats *lookup(Bus bus, uint8_t address, uint8_t route) {
+  DeviceStats *found = search(bus, address, route);
+  if (found || deviceTotal >= MAX_DEVICES) return found;
+  DeviceStats &d = devices[deviceTotal++];
+  memset(&d, 0, sizeof(d));
+  d.bus = bus;
+  d.address = address;
+  d.route = route;
+  return &d;
+}
+
+void record(Bus bus, uint8_t address, uint8_t route, uint16_t transactions, uint32_t bytes,
+            uint16_t errors, uint32_t elapsedMicros) {
+  Util::Lock lock(statsLock);
+  DeviceStats *d = lookup(bus, address, route);
+  if (!d) return;
+  d->accesses++;
+  d->transactions += transactions;
+  d->bytes += bytes;
+  d->errors += errors;
+  d->totalMicros += elapsedMicros;
+  if (elapsedMicros > d->maxMicros) d->maxMicros = elapsedMicros;
+
+  uint8_t bin = 0;
+  while (bin < HISTOGRAM_BINS - 1 && (elapsedMicros >> (bin + 1))) ++bin;
+  d->histogram[bin]++;
+}
+
+uint8_t deviceCount() {
+  Util::Lock lock(statsLock);
+  return deviceTotal;
+}
+
+// Copies are taken under the lock; record() keeps updating the table.
+bool device(uint8_t index, DeviceStats &out) {
+  Util::Lock lock(statsLock);
+  if (index >= deviceTotal) return false;
+  out = devices[index];
+  return true;
+}
+
+bool find(Bus bus, uint8_t address, DeviceStats &out, uint8_t route) {
+  Util::Lock lock(statsLock);
+  const DeviceStats *found = search(bus, address, route);
+  if (!found) return false;
+  out = *found;
+  return true;
+}
+
+void reset() {
+  Util::Lock lock(statsLock);
+  deviceTotal = 0;
+}
+
+#else
+
+void record(Bus, uint8_t, uint8_t, uint16_t, uint32_t, uint16_t, uint32_t) {}
+uint8_t deviceCount() { return 0; }
+bool device(uint8_t, DeviceStats &) { return false; }
+bool find(Bus, uint8_t, DeviceStats &, uint8_t) { return false; }
+void reset() {}
+
+#endif
+
+String toJSON(const DeviceStats &s) {
+  char buf[192];
+  snprintf(buf, sizeof(buf),
+           "{\"accesses\":%lu,\"tx\":%lu,\"bytes\":%lu,\"errors\":%lu,\"avg_us\":%lu,\"max_us\":%lu,\"hist\":[",
+           (unsigned long)s.accesses, (unsigned long)s.transactions,
+           (unsigned long)s.bytes, (unsigned long)s.errors,
+           (unsigned long)(s.accesses ? s.totalMicros / s.accesses : 0),
+           (unsigned long)s.maxMicros);
+  String json(buf);
+  for (uint8_t i = 0; i < HISTOGRAM_BINS; ++i) {
+    snprintf(buf, sizeof(buf), i ? ",%lu" : "%lu", (unsigned long)s.histogram[i]);
+    json += buf;
+  }
+  json += "]}";
+  return json;
+}
+
+static String topicFor(const String &prefix, const DeviceStats &s) {
+  char buf[20];
+  if (s.bus == SPI) {
+    snprintf(buf, sizeof(buf), "/spi/%u", s.address);
+  } else if (s.route == MAIN_BUS) {
+    snprintf(buf, sizeof(buf), "/i2c/%02x", s.address);
+  } else {
+    snprintf(buf, sizeof(buf), "/i2c/%02x/%u/%02x", 0x70 | ((s.route >> 3) & 0x07),
+             s.route & 0x07, s.address);
+  }
+  return prefix + buf;
+}
+
+void publish(const String &prefix) {
+  DeviceStats s;
+  for (uint8_t i = 0; device(i, s); ++i) {
+    EventBus::publish(topicFor(prefix, s), toJSON(s));
+  }
+}
+
+void publish(const String &prefix, bool (*sink)(const char *topic, const char *payload)) {
+  if (!sink) return;
+  DeviceStats s;
+  for (uint8_t i = 0; device(i, s); ++i) {
+    sink(topicFor(prefix, s).c_str(), toJSON(s).c_str());
+  }
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef ESPTOOLS_BUSSTATS_H
+#define ESPTOOLS_BUSSTATS_H
+
+#include <Arduino.h>
+
+// Build with -DESPTOOLS_BUS_STATS=1 to compile bus-transaction counters into
+// the drivers. When 0 (default) every probe is an empty inline object and
+// the drivers carry no instrumentation code. Must be set for the whole
+// build (e.g. build_flags / build.extra_flags), not in a sketch.
+#ifndef ESPTOOLS_BUS_STATS
+#define ESPTOOLS_BUS_STATS 0
+#endif
+
+namespace ESPtools {
+namespace BusStats {
+
+enum Bus : uint8_t { I2C = 0, SPI = 1 };
+
+static constexpr uint8_t MAX_DEVICES    = 24;
+static constexpr uint8_t HISTOGRAM_BINS = 12;
+static constexpr uint8_t MAIN_BUS       = 0;
+
+/**
+ * Route of an I2C device behind a PCA9548A (0x70-0x77) downstream bus, so
+ * same-address devices on different mux channels are counted apart.
+ */
+inline uint8_t route(uint8_t muxAddress, uint8_t bus) {
+  return uint8_t(0x80 | ((muxAddress & 0x07) << 3) | (bus & 0x07));
+}
+
+/**
+ * Counters for one device: I2C address and route, or CS pin for SPI.
+ * histogram[k] counts driver accesses whose bus time was below 2^(k+1) µs
+ * (and at least 2^k µs for k > 0); the last bin takes everything longer.
+ */
+struct DeviceStats {
+  Bus      bus;
+  uint8_t  address;
+  uint8_t  route;        ///< MAIN_BUS or route()
+  uint32_t accesses;
+  uint32_t transactions;
+  uint32_t bytes;
+  uint32_t errors;
+  uint32_t maxMicros;
+  uint64_t totalMicros;
+  uint32_t histogram[HISTOGRAM_BINS];
+};
+
+/**
+ * Add one driver access (one or more bus transactions) to a device's counters.
+ * Task-safe; not for use from ISRs.
+ */
+void record(Bus bus, uint8_t address, uint8_t route, uint16_t transactions, uint32_t bytes,
+            uint16_t errors, uint32_t elapsedMicros);
+
+// Number of devices seen so far
+uint8_t deviceCount();
+
+// Copy the counters at index (0..deviceCount()-1) into out; false if out of range
+bool device(uint8_t index, DeviceStats &out);
+
+// Copy a device's counters into out; false if it has not been accessed
+bool find(Bus bus, uint8_t address, DeviceStats &out, uint8_t route = MAIN_BUS);
+
+// Clear all counters and forget all devices
+void reset();
+
+// JSON object with one device's counters
+String toJSON(const DeviceStats &stats);
+
+// Publish every device to EventBus as <prefix>/i2c/48, <prefix>/spi/5, and
+// <prefix>/i2c/70/3/48 for a device on bus 3 of the mux at 0x70
+void publish(const String &prefix = "esptools/bus");
+
+// Same, through a sink with the MQTT::publish signature
+void publish(const String &prefix, bool (*sink)(const char *topic, const char *payload));
+
+/**
+ * Scoped measurement of one driver access. Construct before the first bus
+ * call, report each transaction, and the destructor records the total.
+ */
+class Probe {
+public:
+#if ESPTOOLS_BUS_STATS
+  Probe(Bus bus, uint8_t address, uint8_t route = MAIN_BUS)
+    : _start(micros()), _bytes(0), _transactions(0), _errors(0),
+      _bus(bus), _address(address), _route(route) {}
+
+  ~Probe() {
+    record(_bus, _address, _route, _transactions, _bytes, _errors, micros() - _start);
+  }
+
+  /**
+   * One bus transaction (START..STOP or one CS window).
+   * @param bytes payload bytes moved, excluding the I2C address byte
+   * @param ok    false on NACK, short read or other failure
+   */
+  void transaction(uint32_t bytes, bool ok = true) {
+    ++_transactions;
+    _bytes += bytes;
+    if (!ok) ++_errors;
+  }
+
+private:
+  uint32_t _start;
+  uint32_t _bytes;
+  uint16_t _transactions;
+  uint16_t _errors;
+  Bus      _bus;
+  uint8_t  _address;
+  uint8_t  _route;
+#else
+  Probe(Bus, uint8_t, uint8_t = MAIN_BUS) {}
+  void transaction(uint32_t, bool = true) {}
+#endif
+};
+
+}
+}
+
+#endif
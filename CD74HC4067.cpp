@@ -3,40 +3,71 @@
 namespace ESPtools {
 namespace Mux {
 
+constexpr uint8_t CD74HC4067::CHANNELS;
+
 CD74HC4067::CD74HC4067(uint8_t s0Pin,
                        uint8_t s1Pin,
                        uint8_t s2Pin,
                        uint8_t s3Pin,
                        int8_t enPin)
-  : _s0(s0Pin), _s1(s1Pin), _s2(s2Pin), _s3(s3Pin), _en(enPin) {}
+  : _s0(s0Pin), _s1(s1Pin), _s2(s2Pin), _s3(s3Pin), _en(enPin), _channel(0xFF),
+    _disabled(false), _settling(false), _order(ScanOrder::Sequential), _settleUs(0),
+    _selectedAt(0) {
+  _select.add(_s0);
+  _select.add(_s1);
+  _select.add(_s2);
+  _select.add(_s3);
+}
 
 void CD74HC4067::begin() {
-  pinMode(_s0, OUTPUT);
-  pinMode(_s1, OUTPUT);
-  pinMode(_s2, OUTPUT);
-  pinMode(_s3, OUTPUT);
+  _select.begin();
+  _channel = 0xFF;
   if (_en >= 0) {
     pinMode(_en, OUTPUT);
     digitalWrite(_en, LOW);
   }
+  _disabled = false;
 }
 
 void CD74HC4067::selectChannel(uint8_t channel) {
   channel &= 0x0F;
-  digitalWrite(_s0, channel & 0x01);
-  digitalWrite(_s1, (channel >> 1) & 0x01);
-  digitalWrite(_s2, (channel >> 2) & 0x01);
-  digitalWrite(_s3, (channel >> 3) & 0x01);
+  if (channel != _channel) {
+    _select.write(channel);
+    _channel = channel;
+    if (_settleUs) {
+      _selectedAt = micros();
+      _settling = true;
+    }
+  }
+  if (_disabled) {
+    digitalWrite(_en, LOW);
+    _disabled = false;
+  }
 }
 
 int CD74HC4067::readAnalog(uint8_t analogPin) {
-
+  if (_settling) {
+    while (micros() - _selectedAt < _settleUs) {}
+    _settling = false;
+  }
   return analogRead(analogPin);
 }
 
+void CD74HC4067::scanAll(uint8_t analogPin, uint16_t out[CHANNELS], uint8_t oversample) {
+  if (!oversample) oversample = 1;
+  for (uint8_t i = 0; i < CHANNELS; ++i) {
+    uint8_t ch = (_order == ScanOrder::Gray) ? uint8_t(i ^ (i >> 1)) : i;
+    selectChannel(ch);
+    uint32_t sum = 0;
+    for (uint8_t n = 0; n < oversample; ++n) sum += uint16_t(readAnalog(analogPin));
+    out[ch] = uint16_t((sum + oversample / 2) / oversample);
+  }
+}
+
 void CD74HC4067::disable() {
   if (_en >= 0) {
     digitalWrite(_en, HIGH);
+    _disabled = true;
   }
 }
 
@@ -2,15 +2,28 @@
 #define ESPTOOLS_CD74HC4067_H
 
 #include <Arduino.h>
+#include "FastGPIO.h"
 
 namespace ESPtools {
 namespace Mux {
 
 /**
  * CD74HC4067 16-channel analog multiplexer/demultiplexer driver.
+ *
+ * The four select lines are written together through Util::PinGroup, so a
+ * channel change is one set/clear register pair instead of four separate
+ * pin writes. Gray-code scan order changes a single select line per step,
+ * which removes intermediate channels entirely.
  */
 class CD74HC4067 {
 public:
+  static constexpr uint8_t CHANNELS = 16;
+
+  enum class ScanOrder : uint8_t {
+    Sequential,   ///< 0, 1, 2, ... 15
+    Gray          ///< 0, 1, 3, 2, 6, ... 8; one select line changes per step
+  };
+
   /**
    * Constructor
    * @param s0Pin   GPIO connected to address bit S0
@@ -39,20 +52,54 @@ public:
 
   /**
    * Read analog value from the given Arduino pin after selecting channel.
+   * Waits out the settle time if the channel changed recently.
    * @param analogPin analog input pin connected to SIG
    * @return analogRead() result
    */
   int readAnalog(uint8_t analogPin);
 
+  /**
+   * Read all 16 channels in the configured scan order.
+   * @param analogPin  analog input pin connected to SIG
+   * @param out        Receives the reading of channel n in out[n]
+   * @param oversample Readings averaged per channel (1 = none)
+   */
+  void scanAll(uint8_t analogPin, uint16_t out[CHANNELS], uint8_t oversample = 1);
+
+  /**
+   * Time to let SIG settle after a channel change before it is sampled.
+   * @param us Microseconds, 0 to sample immediately (default)
+   */
+  void setSettleTime(uint16_t us) { _settleUs = us; }
+
+  uint16_t settleTime() const { return _settleUs; }
+
+  /**
+   * Order in which scanAll() visits the channels.
+   */
+  void setScanOrder(ScanOrder order) { _order = order; }
+
+  /**
+   * Currently selected channel, or 0xFF before the first selection.
+   */
+  uint8_t channel() const { return _channel; }
+
   /**
    * Disable all channel switches (if enable pin is used).
-   * After disable(), no channel is connected.
+   * After disable(), no channel is connected until the next selectChannel().
    */
   void disable();
 
 private:
-  uint8_t _s0, _s1, _s2, _s3;
-  int8_t  _en;
+  uint8_t   _s0, _s1, _s2, _s3;
+  int8_t    _en;
+  Util::PinGroup _select;
+  uint8_t   _channel;
+  bool      _disabled;
+  bool      _settling;
+  ScanOrder _order;
+  uint16_t  _settleUs;
+  uint32_t  _selectedAt;
 };
 
 }
@@ -0,0 +1,328 @@
+#include "ChannelMatrix.h"
+
+namespace ESPtools {
+namespace ADC {
+
+constexpr uint8_t ChannelMatrix::MAX_POINTS;
+constexpr uint8_t ChannelMatrix::MAX_ADCS;
+constexpr uint8_t ChannelMatrix::MAX_MUXES;
+
+ChannelMatrix::ChannelMatrix()
+  : _count(0), _laneCount(0), _muxCount(0), _planned(false), _running(false),
+    _failed(false), _switches(0), _timeouts(0) {}
+
+int8_t ChannelMatrix::addPoint(ADS1115 &adc, uint8_t input, uint8_t gainCode,
+                               uint8_t samples) {
+  int8_t lane = laneFor(&adc, nullptr, nullptr, 0);
+  if (lane < 0) return -1;
+  return add(lane, NONE, 0, input, gainCode, samples);
+}
+
+int8_t ChannelMatrix::addPoint(ADS1256 &adc, uint8_t input, uint8_t gainCode,
+                               uint8_t samples) {
+  if (!adc.hasReadyPin()) return -1;
+  int8_t lane = laneFor(nullptr, &adc, nullptr, 0);
+  if (lane < 0) return -1;
+  return add(lane, NONE, 0, input, gainCode, samples);
+}
+
+int8_t ChannelMatrix::addPoint(Mux::CD74HC4067 &mux, uint8_t muxChannel, ADS1115 &adc,
+                               uint8_t input, uint8_t gainCode, uint8_t samples) {
+  int8_t lane = laneFor(&adc, nullptr, nullptr, 0);
+  int8_t slot = muxSlot(mux);
+  if (lane < 0 || slot < 0) return -1;
+  return add(lane, slot, muxChannel & 0x0F, input, gainCode, samples);
+}
+
+int8_t ChannelMatrix::addPoint(Mux::CD74HC4067 &mux, uint8_t muxChannel, ADS1256 &adc,
+                               uint8_t input, uint8_t gainCode, uint8_t samples) {
+  if (!adc.hasReadyPin()) return -1;
+  int8_t lane = laneFor(nullptr, &adc, nullptr, 0);
+  int8_t slot = muxSlot(mux);
+  if (lane < 0 || slot < 0) return -1;
+  return add(lane, slot, muxChannel & 0x0F, input, gainCode, samples);
+}
+
+int8_t ChannelMatrix::addPoint(Mux::PCA9548A &mux, uint8_t bus, ADS1115 &adc,
+                               uint8_t input, uint8_t gainCode, uint8_t samples) {
+  int8_t lane = laneFor(&adc, nullptr, &mux, bus & 0x07);
+  if (lane < 0) return -1;
+  return add(lane, NONE, 0, input, gainCode, samples);
+}
+
+void ChannelMatrix::clear() {
+  _count = 0;
+  _laneCount = 0;
+  _muxCount = 0;
+  _planned = false;
+  _running = false;
+}
+
+int8_t ChannelMatrix::add(uint8_t lane, uint8_t mux, uint8_t muxChannel, uint8_t input,
+                          uint8_t gainCode, uint8_t samples) {
+  if (_count >= MAX_POINTS || _running) return -1;
+  if (_lanes[lane].ads1115 && input > 0x07) return -1;
+  Point &p = _points[_count];
+  p.lane       = lane;
+  p.mux        = mux;
+  p.muxChannel = muxChannel;
+  p.input      = input;
+  p.gain       = gainCode & 0x07;
+  p.samples    = samples ? samples : 1;
+  _results[_count] = MatrixSample{ 0, 0, false };
+  _planned = false;
+  return int8_t(_count++);
+}
+
+int8_t ChannelMatrix::laneFor(ADS1115 *ads1115, ADS1256 *ads1256, Mux::PCA9548A *i2cMux,
+                              uint8_t bus) {
+  for (uint8_t i = 0; i < _laneCount; ++i) {
+    const Lane &l = _lanes[i];
+    if (l.ads1115 == ads1115 && l.ads1256 == ads1256 && l.i2cMux == i2cMux && l.bus == bus) {
+      return int8_t(i);
+    }
+  }
+  if (_laneCount >= MAX_ADCS) return -1;
+  Lane &l = _lanes[_laneCount];
+  l.ads1115 = ads1115;
+  l.ads1256 = ads1256;
+  l.i2cMux  = i2cMux;
+  l.bus     = bus;
+  l.count   = 0;
+  return int8_t(_laneCount++);
+}
+
+int8_t ChannelMatrix::muxSlot(Mux::CD74HC4067 &mux) {
+  for (uint8_t i = 0; i < _muxCount; ++i) {
+    if (_muxes[i].mux == &mux) return int8_t(i);
+  }
+  if (_muxCount >= MAX_MUXES) return -1;
+  _muxes[_muxCount].mux = &mux;
+  _muxes[_muxCount].owner = -1;
+  _muxes[_muxCount].selectedAt = 0;
+  return int8_t(_muxCount++);
+}
+
+uint32_t ChannelMatrix::orderKey(const Point &p) {
+  // Mux channel before mux: points on different muxes alternate, so the
+  // next mux can be switched while the current point converts. Gain rides
+  // along in the config write that starts every conversion.
+  if (p.mux == NONE) return (uint32_t(p.gain) << 8) | p.input;
+  return (uint32_t(p.muxChannel + 1) << 24) | (uint32_t(p.mux + 1) << 16) |
+         (uint32_t(p.gain) << 8) | p.input;
+}
+
+void ChannelMatrix::plan() {
+  uint8_t n = 0;
+  for (uint8_t lane = 0; lane < _laneCount; ++lane) {
+    Lane &l = _lanes[lane];
+    l.first = n;
+    for (uint8_t i = 0; i < _count; ++i) {
+      const Point &p = _points[i];
+      if (p.lane != lane) continue;
+      // Insertion sort; equal keys keep declaration order.
+      uint32_t key = orderKey(p);
+      uint8_t j = n;
+      while (j > l.first) {
+        if (orderKey(_points[_order[j - 1]]) <= key) break;
+        _order[j] = _order[j - 1];
+        --j;
+      }
+      _order[j] = i;
+      ++n;
+    }
+    l.count = n - l.first;
+  }
+  _planned = true;
+}
+
+bool ChannelMatrix::sample(uint32_t *sweepMicros) {
+  unsigned long t0 = micros();
+  if (!start()) return false;
+  while (!poll()) yield();
+  if (sweepMicros) *sweepMicros = micros() - t0;
+  return !_failed;
+}
+
+bool ChannelMatrix::start() {
+  if (_count == 0) return false;
+  if (!_planned) plan();
+  for (uint8_t i = 0; i < _muxCount; ++i) _muxes[i].owner = -1;
+  for (uint8_t i = 0; i < _laneCount; ++i) {
+    Lane &l = _lanes[i];
+    l.next  = 0;
+    l.state = l.count ? State::Select : State::Done;
+  }
+  _switches = 0;
+  _failed = false;
+  _running = true;
+  poll();
+  return true;
+}
+
+bool ChannelMatrix::poll() {
+  if (!_running) return false;
+  bool done = true;
+  for (uint8_t i = 0; i < _laneCount; ++i) {
+    if (!step(i)) done = false;
+  }
+  if (!done) return false;
+  _running = false;
+  return true;
+}
+
+const MatrixSample &ChannelMatrix::result(uint8_t point) const {
+  static const MatrixSample none = { 0, 0, false };
+  return point < _count ? _results[point] : none;
+}
+
+float ChannelMatrix::voltage(uint8_t point) const {
+  if (point >= _count) return 0.0f;
+  const Point &p = _points[point];
+  const Lane &l = _lanes[p.lane];
+  const Scale &s = l.ads1115 ? l.ads1115->scale(p.gain) : l.ads1256->scale(p.gain);
+  return s.toVolts(_results[point].raw);
+}
+
+int32_t ChannelMatrix::microvolts(uint8_t point) const {
+  if (point >= _count) return 0;
+  const Point &p = _points[point];
+  const Lane &l = _lanes[p.lane];
+  const Scale &s = l.ads1115 ? l.ads1115->scale(p.gain) : l.ads1256->scale(p.gain);
+  return s.toMicrovolts(_results[point].raw);
+}
+
+bool ChannelMatrix::acquire(uint8_t lane, const Point &p) {
+  if (p.mux == NONE) return true;
+  AnalogMux &m = _muxes[p.mux];
+  if (m.owner >= 0 && m.owner != lane) return false;
+  m.owner = lane;
+  if (m.mux->channel() != p.muxChannel) {
+    m.mux->selectChannel(p.muxChannel);
+    m.selectedAt = micros();
+    ++_switches;
+  }
+  return true;
+}
+
+void ChannelMatrix::release(uint8_t lane, uint8_t mux) {
+  if (mux != NONE && _muxes[mux].owner == lane) _muxes[mux].owner = -1;
+}
+
+bool ChannelMatrix::settled(const Point &p) const {
+  if (p.mux == NONE) return true;
+  const AnalogMux &m = _muxes[p.mux];
+  return micros() - m.selectedAt >= m.mux->settleTime();
+}
+
+void ChannelMatrix::startConversion(Lane &l, const Point &p) {
+  if (l.ads1115) {
+    if (l.i2cMux) l.i2cMux->selectBus(l.bus);
+    l.ads1115->startConversion(p.input, p.gain);
+  } else {
+    l.ads1256->startConversion(p.input, p.gain);
+  }
+  l.started = micros();
+}
+
+bool ChannelMatrix::conversionReady(Lane &l, bool &timedOut) {
+  uint32_t elapsed = micros() - l.started;
+  bool ready;
+  if (l.ads1256) {
+    ready = l.ads1256->isReady();
+    // Slowest data rate plus filter settling stays well below a second.
+    timedOut = !ready && elapsed > 1000000UL;
+    return ready || timedOut;
+  }
+
+  ADS1115 &adc = *l.ads1115;
+  uint32_t nominal = adc.conversionMicros();
+  if (adc.hasReadyPin()) {
+    ready = adc.isReady();
+  } else if (elapsed < nominal) {
+    // Not worth an I2C read before the nominal conversion time.
+    ready = false;
+  } else {
+    if (l.i2cMux) l.i2cMux->selectBus(l.bus);
+    ready = adc.isReady();
+  }
+  timedOut = !ready && elapsed > nominal * 2 + 1000;
+  return ready || timedOut;
+}
+
+int32_t ChannelMatrix::readConversion(Lane &l) {
+  if (l.ads1256) return l.ads1256->readConversion();
+  if (l.i2cMux) l.i2cMux->selectBus(l.bus);
+  return l.ads1115->readConversion();
+}
+
+void ChannelMatrix::prefetch(uint8_t lane) {
+  // The next point's mux is not in the signal path being converted now,
+  // so it can switch and settle in parallel.
+  Lane &l = _lanes[lane];
+  if (l.next + 1 >= l.count) return;
+  const Point &cur  = _points[_order[l.first + l.next]];
+  const Point &next = _points[_order[l.first + l.next + 1]];
+  if (next.mux != NONE && next.mux != cur.mux) acquire(lane, next);
+}
+
+void ChannelMatrix::finishPoint(uint8_t lane) {
+  Lane &l = _lanes[lane];
+  uint8_t index = _order[l.first + l.next];
+  const Point &p = _points[index];
+
+  MatrixSample &r = _results[index];
+  r.raw = l.failed ? 0 : int32_t(l.sum / p.samples);
+  r.timestamp = micros();
+  r.ok = !l.failed;
+  if (l.failed) _failed = true;
+
+  ++l.next;
+  uint8_t nextMux = (l.next < l.count) ? _points[_order[l.first + l.next]].mux : NONE;
+  if (p.mux != nextMux) release(lane, p.mux);
+  l.state = (l.next < l.count) ? State::Select : State::Done;
+}
+
+bool ChannelMatrix::step(uint8_t lane) {
+  Lane &l = _lanes[lane];
+  while (l.state != State::Done) {
+    const Point &p = _points[_order[l.first + l.next]];
+
+    if (l.state == State::Select) {
+      if (!acquire(lane, p)) return false;
+      l.state = State::Settle;
+    }
+
+    if (l.state == State::Settle) {
+      if (!settled(p)) return false;
+      l.remaining = p.samples;
+      l.sum = 0;
+      l.failed = false;
+      startConversion(l, p);
+      prefetch(lane);
+      l.state = State::Convert;
+      return false;
+    }
+
+    bool timedOut = false;
+    if (!conversionReady(l, timedOut)) return false;
+    if (timedOut) {
+      ++_timeouts;
+      l.failed = true;
+      l.remaining = 1;
+    } else {
+      l.sum += readConversion(l);
+    }
+    if (--l.remaining > 0) {
+      // ADS1115 runs single-shot; the ADS1256 keeps converting on its own.
+      if (l.ads1115) startConversion(l, p);
+      else           l.started = micros();
+      return false;
+    }
+    finishPoint(lane);
+  }
+  return true;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#ifndef ESPTOOLS_CHANNELMATRIX_H
+#define ESPTOOLS_CHANNELMATRIX_H
+
+#include <Arduino.h>
+#include "ADS1115.h"
+#include "ADS1256.h"
+#include "CD74HC4067.h"
+#include "PCA9548A.h"
+
+namespace ESPtools {
+namespace ADC {
+
+/**
+ * One acquired point of a ChannelMatrix sweep.
+ */
+struct MatrixSample {
+  int32_t  raw;        ///< ADC code, averaged over the point's samples
+  uint32_t timestamp;  ///< micros() when the last sample was read
+  bool     ok;         ///< false if a conversion timed out
+};
+
+/**
+ * Acquisition engine for fixtures with analog muxes in front of ADC
+ * inputs. Points are declared once as (mux, mux channel, ADC, ADC input,
+ * gain, samples); each sweep fills a contiguous, timestamped result array
+ * in declaration order.
+ *
+ * Execution order is planned per ADC: every (mux, channel) pair is
+ * selected once per sweep, and points of different muxes alternate so the
+ * next mux can be switched and settle while the current point converts.
+ * Each ADC runs its own sequence and all of them are driven from one poll
+ * loop, so settling on one ADC overlaps conversions on the others.
+ *
+ * ADS1115 conversions are single-shot and are collected via ALERT/RDY when
+ * wired, otherwise from the OS bit once the nominal conversion time is
+ * over. ADS1256 points restart the filter (SYNC/WAKEUP) and need a DRDY
+ * pin. ADCs must already be begun and set to the wanted data rate; muxes
+ * must be begun and carry their settle time (CD74HC4067::setSettleTime()).
+ */
+class ChannelMatrix {
+public:
+  static constexpr uint8_t MAX_POINTS = 64;
+  static constexpr uint8_t MAX_ADCS   = 8;
+  static constexpr uint8_t MAX_MUXES  = 8;
+
+  ChannelMatrix();
+
+  /**
+   * Add a point read directly on an ADC input.
+   * @param adc      ADC driver
+   * @param input    MUX code (ADS1115/ADS1256 singleEnded() / differential())
+   * @param gainCode PGA gain (GAIN_ constants of that ADC)
+   * @param samples  Conversions averaged for this point
+   * @return point index, or -1 if a table is full or the ADS1256 has no DRDY
+   */
+  int8_t addPoint(ADS1115 &adc, uint8_t input, uint8_t gainCode, uint8_t samples = 1);
+  int8_t addPoint(ADS1256 &adc, uint8_t input, uint8_t gainCode, uint8_t samples = 1);
+
+  /**
+   * Add a point routed through a CD74HC4067 whose SIG feeds the ADC input.
+   * @param mux        analog mux
+   * @param muxChannel mux channel (0-15)
+   */
+  int8_t addPoint(Mux::CD74HC4067 &mux, uint8_t muxChannel, ADS1115 &adc, uint8_t input,
+                  uint8_t gainCode, uint8_t samples = 1);
+  int8_t addPoint(Mux::CD74HC4067 &mux, uint8_t muxChannel, ADS1256 &adc, uint8_t input,
+                  uint8_t gainCode, uint8_t samples = 1);
+
+  /**
+   * Add a point on an ADS1115 that sits on a downstream bus of a PCA9548A.
+   * The bus is selected before each access, so one driver object can stand
+   * for identical devices on different buses.
+   * @param mux I2C mux
+   * @param bus downstream bus (0-7)
+   */
+  int8_t addPoint(Mux::PCA9548A &mux, uint8_t bus, ADS1115 &adc, uint8_t input,
+                  uint8_t gainCode, uint8_t samples = 1);
+
+  /**
+   * Remove all points.
+   */
+  void clear();
+
+  /**
+   * Run one full sweep, blocking until every point has a result.
+   * @param sweepMicros optional, receives the sweep duration
+   * @return false if any conversion timed out
+   */
+  bool sample(uint32_t *sweepMicros = nullptr);
+
+  /**
+   * Begin a sweep without waiting. Drive it with poll().
+   */
+  bool start();
+
+  /**
+   * Advance a running sweep.
+   * @return true once the sweep is complete
+   */
+  bool poll();
+
+  bool isRunning() const { return _running; }
+
+  /**
+   * Results of the last sweep, indexed by point.
+   */
+  const MatrixSample *results() const { return _results; }
+
+  /**
+   * Result of one point; for an unknown point (or an empty matrix) a
+   * sample with ok == false and raw == 0.
+   */
+  const MatrixSample &result(uint8_t point) const;
+
+  /**
+   * Result of a point in volts, using that point's ADC and gain.
+   */
+  float voltage(uint8_t point) const;
+
+  /**
+   * Result of a point in microvolts, using that point's ADC and gain.
+   */
+  int32_t microvolts(uint8_t point) const;
+
+  uint8_t pointCount() const { return _count; }
+
+  /**
+   * Analog mux channel changes made during the last sweep.
+   */
+  uint16_t muxSwitches() const { return _switches; }
+
+  /**
+   * Conversions that did not finish in time, since construction.
+   */
+  uint32_t timeoutCount() const { return _timeouts; }
+
+private:
+  static constexpr uint8_t NONE = 0xFF;
+
+  enum class State : uint8_t { Select, Settle, Convert, Done };
+
+  struct Point {
+    uint8_t lane;
+    uint8_t mux;        // slot in _muxes, or NONE
+    uint8_t muxChannel;
+    uint8_t input;
+    uint8_t gain;
+    uint8_t samples;
+  };
+
+  struct Lane {
+    ADS1115       *ads1115;
+    ADS1256       *ads1256;
+    Mux::PCA9548A *i2cMux;
+    uint8_t        bus;
+    uint8_t        first;    // range of this lane in _order
+    uint8_t        count;
+    uint8_t        next;
+    State          state;
+    uint8_t        remaining;
+    int64_t        sum;
+    uint32_t       started;
+    bool           failed;
+  };
+
+  struct AnalogMux {
+    Mux::CD74HC4067 *mux;
+    int8_t           owner;       // lane holding the channel, or -1
+    uint32_t         selectedAt;
+  };
+
+  Point        _points[MAX_POINTS];
+  uint8_t      _order[MAX_POINTS];
+  MatrixSample _results[MAX_POINTS];
+  Lane         _lanes[MAX_ADCS];
+  AnalogMux    _muxes[MAX_MUXES];
+  uint8_t      _count;
+  uint8_t      _laneCount;
+  uint8_t      _muxCount;
+  bool         _planned;
+  bool         _running;
+  bool         _failed;
+  uint16_t     _switches;
+  uint32_t     _timeouts;
+
+  int8_t add(uint8_t lane, uint8_t mux, uint8_t muxChannel, uint8_t input, uint8_t gainCode,
+             uint8_t samples);
+  int8_t laneFor(ADS1115 *ads1115, ADS1256 *ads1256, Mux::PCA9548A *i2cMux, uint8_t bus);
+  int8_t muxSlot(Mux::CD74HC4067 &mux);
+  static uint32_t orderKey(const Point &p);
+  void plan();
+  bool acquire(uint8_t lane, const Point &p);
+  void release(uint8_t lane, uint8_t mux);
+  bool settled(const Point &p) const;
+  void startConversion(Lane &l, const Point &p);
+  bool conversionReady(Lane &l, bool &timedOut);
+  int32_t readConversion(Lane &l);
+  void prefetch(uint8_t lane);
+  void finishPoint(uint8_t lane);
+  bool step(uint8_t lane);
+};
+
+}
+}
+
+#endif
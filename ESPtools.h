@@ -6,12 +6,26 @@
 #include "WiFiEnterprise.h"
 #include "ButtonManager.h"
 #include "ADS1256.h"
+#include "ADS1256Group.h"
 #include "ADS1115.h"
+#include "ADS1115Scanner.h"
+#include "ADS1115Group.h"
+#include "ChannelMatrix.h"
+#include "ADCScale.h"
+#include "ADCFilter.h"
 #include "EventBus.h"
+#include "EventChannel.h"
 #include "UARTBridge.h"
 #include "MQTTClient.h"
 #include "PCF8575.h"
 #include "CD74HC4067.h"
 #include "PCA9548A.h"
+#include "I2CScheduler.h"
+#include "I2CTopology.h"
+#include "RingBuffer.h"
+#include "BusStats.h"
+#include "Mutex.h"
+#include "SPIDevice.h"
+#include "FastGPIO.h"
 
 #endif
@@ -1,30 +1,559 @@
 #include "EventBus.h"
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace ESPtools {
 namespace EventBus {
 
+static constexpr uint16_t NONE       = 0xFFFF;
+static constexpr uint16_t INDEX_SIZE = 512;  // power of two, at least 2 * MAX_TOPICS
+
+struct Subscription { MessageHandler cb; uint16_t next; };
+
+// Exact topic; subscriptions without wildcards hang off it.
+struct Topic { String name; uint32_t hash; uint16_t subs; Priority lane; };
+
+// One level of the wildcard filter trie.
+struct FilterNode {
+  String   segment;
+  uint16_t child;     // first literal child
+  uint16_t sibling;
+  uint16_t plus;      // "+" child
+  uint16_t subs;      // filters ending at this level
+  uint16_t hashSubs;  // filters ending in "#" below this level
+};
 
-static const uint8_t MAX_SUBSCRIPTIONS = 16;
-struct Subscription { String topic; Handler cb; };
 static Subscription subscriptions[MAX_SUBSCRIPTIONS];
-static uint8_t subCount = 0;
+static uint16_t subCount = 0;
+static Topic topics[MAX_TOPICS];
+static uint16_t topicCount = 0;
+static uint16_t topicIndex[INDEX_SIZE];  // topic + 1, 0 = empty
+static FilterNode nodes[MAX_FILTER_NODES];
+static uint16_t nodeCount = 0;
+static uint32_t subscribeFailed = 0;
+static uint32_t busGeneration = 1;  // 0 is never current
+
+static uint32_t hashTopic(View s) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < s.length; ++i) h = (h ^ uint8_t(s.data[i])) * 16777619u;
+  return h;
+}
+
+static bool sameText(const String& a, const char* b, size_t len) {
+  return a.length() == len && memcmp(a.c_str(), b, len) == 0;
+}
+
+// Index slot holding the topic, or the empty slot where it would go.
+static uint16_t findSlot(View name, uint32_t hash) {
+  uint16_t slot = hash & (INDEX_SIZE - 1);
+  while (topicIndex[slot]) {
+    const Topic& t = topics[topicIndex[slot] - 1];
+    if (t.hash == hash && sameText(t.name, name.data, name.length)) break;
+    slot = (slot + 1) & (INDEX_SIZE - 1);
+  }
+  return slot;
+}
+
+static TopicId findTopic(View name) {
+  uint16_t slot = findSlot(name, hashTopic(name));
+  return topicIndex[slot] ? topicIndex[slot] - 1 : NO_TOPIC;
+}
+
+static uint16_t newNode(const char* segment, size_t len) {
+  if (nodeCount >= MAX_FILTER_NODES) return NONE;
+  FilterNode& n = nodes[nodeCount];
+  n.segment = String(segment, len);
+  n.child = n.sibling = n.plus = n.subs = n.hashSubs = NONE;
+  return nodeCount++;
+}
+
+static uint16_t literalChild(uint16_t parent, const char* segment, size_t len) {
+  for (uint16_t c = nodes[parent].child; c != NONE; c = nodes[c].sibling) {
+    if (sameText(nodes[c].segment, segment, len)) return c;
+  }
+  uint16_t c = newNode(segment, len);
+  if (c == NONE) return NONE;
+  nodes[c].sibling = nodes[parent].child;
+  nodes[parent].child = c;
+  return c;
+}
+
+static uint16_t plusChild(uint16_t parent) {
+  if (nodes[parent].plus == NONE) nodes[parent].plus = newNode("+", 1);
+  return nodes[parent].plus;
+}
+
+// Walk a wildcard filter into the trie; returns the list it subscribes to.
+static uint16_t* filterList(View filter) {
+  if (nodeCount == 0 && newNode("", 0) == NONE) return nullptr;
+  const char* s = filter.data;
+  size_t len = filter.length;
+  uint16_t node = 0;
+  size_t pos = 0;
+  while (true) {
+    const char* slash = static_cast<const char*>(memchr(s + pos, '/', len - pos));
+    size_t stop = slash ? size_t(slash - s) : len;
+    const char* seg = s + pos;
+    size_t segLen = stop - pos;
+    if (segLen == 1 && seg[0] == '#') {
+      return stop == len ? &nodes[node].hashSubs : nullptr;
+    }
+    if (segLen == 1 && seg[0] == '+') {
+      node = plusChild(node);
+    } else if (memchr(seg, '+', segLen) || memchr(seg, '#', segLen)) {
+      return nullptr;
+    } else {
+      node = literalChild(node, seg, segLen);
+    }
+    if (node == NONE) return nullptr;
+    if (stop == len) return &nodes[node].subs;
+    pos = stop + 1;
+  }
+}
+
+static bool addSubscription(uint16_t* head, MessageHandler cb) {
+  if (subCount >= MAX_SUBSCRIPTIONS || !cb) return false;
+  // Append so handlers run in subscription order.
+  subscriptions[subCount].cb = std::move(cb);
+  subscriptions[subCount].next = NONE;
+  while (*head != NONE) head = &subscriptions[*head].next;
+  *head = subCount++;
+  return true;
+}
+
+static void dispatch(uint16_t head, const Message& msg) {
+  for (uint16_t i = head; i != NONE; i = subscriptions[i].next) subscriptions[i].cb(msg);
+}
+
+// pos > length once every level of the topic has been consumed.
+static void matchFilters(uint16_t node, size_t pos, bool system, const Message& msg) {
+  const FilterNode& n = nodes[node];
+  const char* topic = msg.topicName.data;
+  size_t len = msg.topicName.length;
+  if (!system) dispatch(n.hashSubs, msg);
+  if (pos > len) {
+    dispatch(n.subs, msg);
+    return;
+  }
+  const char* slash = static_cast<const char*>(memchr(topic + pos, '/', len - pos));
+  size_t stop = slash ? size_t(slash - topic) : len;
+  for (uint16_t c = n.child; c != NONE; c = nodes[c].sibling) {
+    if (sameText(nodes[c].segment, topic + pos, stop - pos)) {
+      matchFilters(c, stop + 1, false, msg);
+      break;
+    }
+  }
+  if (n.plus != NONE && !system) matchFilters(n.plus, stop + 1, false, msg);
+}
+
+static void deliver(const Message& msg) {
+  if (msg.topic != NO_TOPIC) dispatch(topics[msg.topic].subs, msg);
+  if (nodeCount) {
+    bool system = msg.topicName.length > 0 && msg.topicName.data[0] == '$';
+    matchFilters(0, 0, system, msg);
+  }
+}
+
+// Deferred dispatch: one bounded multi-producer ring (Vyukov) per lane.
+// The producer that claims position p may fill slot p % QUEUE_DEPTH when
+// its sequence equals p, and publishes it by setting p + 1; the consumer
+// frees it for the next lap with p + QUEUE_DEPTH. Sequences are stored
+// minus the slot index so the zero-initialized array starts out valid.
+struct QueueSlot {
+  std::atomic<uint32_t> seq;
+  TopicId               topic;
+  uint8_t               length;
+  char                  data[MAX_QUEUED_PAYLOAD];
+};
+
+struct Lane {
+  QueueSlot             slots[QUEUE_DEPTH];
+  std::atomic<uint32_t> enqueuePos;
+  std::atomic<uint32_t> dequeuePos;  // written by the consumer only
+  uint16_t              depth;       // 0 until setLane(): QUEUE_DEPTH
+  Overflow              policy;
+  std::atomic<uint32_t> enqueued;
+  std::atomic<uint32_t> dispatched;
+  std::atomic<uint32_t> dropped;
+  std::atomic<uint32_t> coalesced;
+  std::atomic<uint32_t> maxDepth;
+};
+
+static Lane lanes[LANES];
+// Messages per topic between post() and dispatch; lets Coalesce see a
+// newer one without searching the ring.
+static std::atomic<uint32_t> topicQueued[MAX_TOPICS];
+
+static inline uint32_t slotSeq(const Lane& lane, uint16_t i) {
+  return lane.slots[i].seq.load(std::memory_order_acquire) + i;
+}
+
+static inline void setSlotSeq(Lane& lane, uint16_t i, uint32_t seq) {
+  lane.slots[i].seq.store(seq - i, std::memory_order_release);
+}
+
+static inline uint32_t laneDepth(const Lane& lane) {
+  return lane.depth ? lane.depth : QUEUE_DEPTH;
+}
+
+static bool hasQueued(const Lane& lane) {
+  uint32_t pos = lane.dequeuePos.load(std::memory_order_relaxed);
+  return slotSeq(lane, pos & (QUEUE_DEPTH - 1)) == pos + 1;
+}
+
+static Lane* nextLane() {
+  for (uint8_t l = 0; l < LANES; ++l) {
+    if (hasQueued(lanes[l])) return &lanes[l];
+  }
+  return nullptr;
+}
+
+static bool hasQueued() {
+  return nextLane() != nullptr;
+}
+
+// Dispatch or discard the oldest message of a lane.
+static void dispatchNext(Lane& lane) {
+  uint32_t pos = lane.dequeuePos.load(std::memory_order_relaxed);
+  uint16_t i = pos & (QUEUE_DEPTH - 1);
+  const QueueSlot& slot = lane.slots[i];
+  uint32_t newer = topicQueued[slot.topic].fetch_sub(1, std::memory_order_relaxed) - 1;
+  uint32_t behind = lane.enqueuePos.load(std::memory_order_relaxed) - pos - 1;
+  if (lane.policy != Overflow::DropNewest && behind >= laneDepth(lane)) {
+    lane.dropped.fetch_add(1, std::memory_order_relaxed);
+  } else if (lane.policy == Overflow::Coalesce && newer) {
+    lane.coalesced.fetch_add(1, std::memory_order_relaxed);
+  } else if (slot.topic < topicCount) {
+    Message msg;
+    msg.topic     = slot.topic;
+    msg.topicName = View(topics[slot.topic].name);
+    msg.payload   = View(slot.data, slot.length);
+    deliver(msg);
+    lane.dispatched.fetch_add(1, std::memory_order_relaxed);
+  }
+  setSlotSeq(lane, i, pos + QUEUE_DEPTH);
+  lane.dequeuePos.store(pos + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);  // pairs with post()
+}
+
+// Single consumer: either loop() or the dispatcher task. The highest lane
+// with a message goes first, re-checked after every message.
+static size_t drain(size_t maxMessages) {
+  size_t n = 0;
+  Lane* lane;
+  while (n < maxMessages && (lane = nextLane()) != nullptr) {
+    dispatchNext(*lane);
+    ++n;
+  }
+  return n;
+}
+
+static void resetCounters(Lane& lane) {
+  lane.enqueued.store(0, std::memory_order_relaxed);
+  lane.dispatched.store(0, std::memory_order_relaxed);
+  lane.dropped.store(0, std::memory_order_relaxed);
+  lane.coalesced.store(0, std::memory_order_relaxed);
+  lane.maxDepth.store(0, std::memory_order_relaxed);
+}
+
+static void resetQueue() {
+  for (uint8_t l = 0; l < LANES; ++l) {
+    Lane& lane = lanes[l];
+    for (uint16_t i = 0; i < QUEUE_DEPTH; ++i) lane.slots[i].seq.store(0, std::memory_order_relaxed);
+    lane.enqueuePos.store(0, std::memory_order_relaxed);
+    lane.dequeuePos.store(0, std::memory_order_relaxed);
+    lane.depth  = 0;
+    lane.policy = Overflow::DropNewest;
+    resetCounters(lane);
+  }
+  for (uint16_t i = 0; i < MAX_TOPICS; ++i) topicQueued[i].store(0, std::memory_order_relaxed);
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+static TaskHandle_t dispatcherTask = nullptr;
+static volatile bool dispatcherStop = false;
+
+static void IRAM_ATTR wakeDispatcher() {
+  TaskHandle_t task = dispatcherTask;
+  if (!task) return;
+  if (xPortInIsrContext()) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+  } else {
+    xTaskNotifyGive(task);
+  }
+}
+
+static void dispatcherMain(void*) {
+  while (!dispatcherStop) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+    while (drain(QUEUE_DEPTH) == QUEUE_DEPTH) {}
+  }
+  dispatcherTask = nullptr;
+  vTaskDelete(nullptr);
+}
+
+bool startDispatcher(uint8_t priority, uint32_t stackBytes) {
+  if (dispatcherTask) return false;
+  dispatcherStop = false;
+  return xTaskCreate(dispatcherMain, "eventbus", stackBytes, nullptr, priority,
+                     &dispatcherTask) == pdPASS;
+}
+
+void stopDispatcher() {
+  if (!dispatcherTask) return;
+  dispatcherStop = true;
+  xTaskNotifyGive(dispatcherTask);
+  while (dispatcherTask) vTaskDelay(1);
+}
+
+static bool dispatcherRunning() { return dispatcherTask != nullptr; }
+
+#elif !defined(ARDUINO)
+
+static std::thread dispatcherThread;
+static std::mutex wakeMutex;
+static std::condition_variable wakeSignal;
+static std::atomic<bool> dispatcherActive(false);
+static std::atomic<bool> dispatcherStop(false);
+
+static void wakeDispatcher() {
+  if (dispatcherActive.load(std::memory_order_relaxed)) wakeSignal.notify_one();
+}
+
+static void dispatcherMain() {
+  while (!dispatcherStop.load()) {
+    if (!hasQueued()) {
+      // Producers notify without the lock; the timeout bounds a missed wakeup.
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      wakeSignal.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    while (drain(QUEUE_DEPTH) == QUEUE_DEPTH) {}
+  }
+}
+
+bool startDispatcher(uint8_t, uint32_t) {
+  if (dispatcherActive.load()) return false;
+  dispatcherStop.store(false);
+  dispatcherActive.store(true);
+  dispatcherThread = std::thread(dispatcherMain);
+  return true;
+}
+
+void stopDispatcher() {
+  if (!dispatcherActive.load()) return;
+  dispatcherStop.store(true);
+  wakeSignal.notify_one();
+  dispatcherThread.join();
+  dispatcherActive.store(false);
+}
+
+static bool dispatcherRunning() { return dispatcherActive.load(); }
+
+#else
+
+static void wakeDispatcher() {}
+bool startDispatcher(uint8_t, uint32_t) { return false; }
+void stopDispatcher() {}
+static bool dispatcherRunning() { return false; }
+
+#endif
+
+bool IRAM_ATTR post(TopicId topic, View payload) {
+  if (topic >= topicCount) {
+    lanes[uint8_t(Priority::Normal)].dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  Lane& lane = lanes[uint8_t(topics[topic].lane)];
+  if (payload.length > MAX_QUEUED_PAYLOAD) {
+    lane.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  // DropNewest refuses at the configured depth; the other policies take
+  // the message while the ring has room and discard old ones at dispatch.
+  uint32_t limit = lane.policy == Overflow::DropNewest ? laneDepth(lane) : QUEUE_DEPTH;
+  uint32_t pos = lane.enqueuePos.load(std::memory_order_relaxed);
+  while (true) {
+    int32_t diff = int32_t(slotSeq(lane, pos & (QUEUE_DEPTH - 1)) - pos);
+    if (diff < 0 || pos - lane.dequeuePos.load(std::memory_order_relaxed) >= limit) {
+      lane.dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (diff == 0) {
+      if (lane.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else {
+      pos = lane.enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+  topicQueued[topic].fetch_add(1, std::memory_order_relaxed);
+  lane.enqueued.fetch_add(1, std::memory_order_relaxed);
+  uint32_t depth = pos + 1 - lane.dequeuePos.load(std::memory_order_relaxed);
+  uint32_t high = lane.maxDepth.load(std::memory_order_relaxed);
+  while (depth > high &&
+         !lane.maxDepth.compare_exchange_weak(high, depth, std::memory_order_relaxed)) {}
+
+  uint16_t i = pos & (QUEUE_DEPTH - 1);
+  QueueSlot& slot = lane.slots[i];
+  slot.topic  = topic;
+  slot.length = uint8_t(payload.length);
+  memcpy(slot.data, payload.data, payload.length);
+  setSlotSeq(lane, i, pos + 1);
+  // Only the message at the head of a lane can find the consumer idle;
+  // later ones are picked up by the same drain pass.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (lane.dequeuePos.load(std::memory_order_relaxed) == pos) wakeDispatcher();
+  return true;
+}
+
+size_t loop(size_t maxMessages) {
+  if (dispatcherRunning()) return 0;
+  return drain(maxMessages);
+}
+
+void setLane(Priority lane, uint16_t depth, Overflow policy) {
+  Lane& l = lanes[uint8_t(lane)];
+  l.depth  = constrain(depth, uint16_t(1), QUEUE_DEPTH);
+  l.policy = policy;
+}
+
+bool setPriority(TopicId topic, Priority lane) {
+  if (topic >= topicCount) return false;
+  topics[topic].lane = lane;
+  return true;
+}
+
+LaneStats laneStats(Priority lane) {
+  const Lane& l = lanes[uint8_t(lane)];
+  LaneStats stats;
+  stats.enqueued   = l.enqueued.load(std::memory_order_relaxed);
+  stats.dispatched = l.dispatched.load(std::memory_order_relaxed);
+  stats.dropped    = l.dropped.load(std::memory_order_relaxed);
+  stats.coalesced  = l.coalesced.load(std::memory_order_relaxed);
+  stats.depth      = uint16_t(l.enqueuePos.load(std::memory_order_relaxed) -
+                              l.dequeuePos.load(std::memory_order_relaxed));
+  stats.maxDepth   = uint16_t(l.maxDepth.load(std::memory_order_relaxed));
+  return stats;
+}
+
+void resetStats() {
+  for (uint8_t l = 0; l < LANES; ++l) resetCounters(lanes[l]);
+  subscribeFailed = 0;
+}
+
+size_t pending() {
+  size_t n = 0;
+  for (uint8_t l = 0; l < LANES; ++l) {
+    n += lanes[l].enqueuePos.load(std::memory_order_relaxed) -
+         lanes[l].dequeuePos.load(std::memory_order_relaxed);
+  }
+  return n;
+}
+
+uint32_t dropped() {
+  uint32_t n = 0;
+  for (uint8_t l = 0; l < LANES; ++l) n += lanes[l].dropped.load(std::memory_order_relaxed);
+  return n;
+}
+
+uint32_t IRAM_ATTR generation() {
+  return busGeneration;
+}
+
+uint32_t subscribeFailures() {
+  return subscribeFailed;
+}
 
 void begin() {
+  resetQueue();
+  subscribeFailed = 0;
+  ++busGeneration;
+  if (busGeneration == 0) busGeneration = 1;
+  for (uint16_t i = 0; i < subCount; ++i) subscriptions[i].cb = nullptr;
+  for (uint16_t i = 0; i < topicCount; ++i) topics[i].name = String();
+  for (uint16_t i = 0; i < nodeCount; ++i) nodes[i].segment = String();
+  memset(topicIndex, 0, sizeof(topicIndex));
   subCount = 0;
+  topicCount = 0;
+  nodeCount = 0;
+}
+
+TopicId topic(View name) {
+  uint32_t hash = hashTopic(name);
+  uint16_t slot = findSlot(name, hash);
+  if (topicIndex[slot]) return topicIndex[slot] - 1;
+  if (topicCount >= MAX_TOPICS) return NO_TOPIC;
+  Topic& t = topics[topicCount];
+  t.name = name.toString();
+  t.hash = hash;
+  t.subs = NONE;
+  t.lane = Priority::Normal;
+  topicIndex[slot] = ++topicCount;
+  return topicCount - 1;
+}
+
+const char* topicName(TopicId id) {
+  return id < topicCount ? topics[id].name.c_str() : "";
+}
+
+static bool subscribed(bool ok) {
+  if (!ok) ++subscribeFailed;
+  return ok;
 }
 
-void subscribe(const String& topic, Handler cb) {
-  if (subCount < MAX_SUBSCRIPTIONS) {
-    subscriptions[subCount++] = { topic, cb };
+bool subscribe(TopicId id, MessageHandler cb) {
+  return subscribed(id < topicCount && addSubscription(&topics[id].subs, std::move(cb)));
+}
+
+bool subscribe(View filter, MessageHandler cb) {
+  uint16_t* head;
+  if (memchr(filter.data, '+', filter.length) || memchr(filter.data, '#', filter.length)) {
+    head = filterList(filter);
+  } else {
+    TopicId id = topic(filter);
+    head = id != NO_TOPIC ? &topics[id].subs : nullptr;
   }
+  return subscribed(head && addSubscription(head, std::move(cb)));
+}
+
+bool subscribe(const String& topic, Handler cb) {
+  if (!cb) return subscribed(false);
+  return subscribe(View(topic), [cb](const Message& msg) { cb(msg.payload.toString()); });
+}
+
+void publish(TopicId id, View payload) {
+  if (id >= topicCount) return;
+  Message msg;
+  msg.topic     = id;
+  msg.topicName = View(topics[id].name);
+  msg.payload   = payload;
+  deliver(msg);
+}
+
+void publish(View topic, View payload) {
+  Message msg;
+  msg.topic     = findTopic(topic);
+  msg.topicName = topic;
+  msg.payload   = payload;
+  deliver(msg);
+}
+
+void publish(const char* topic, const char* payload) {
+  publish(View(topic), View(payload));
 }
 
 void publish(const String& topic, const String& payload) {
-  for (uint8_t i = 0; i < subCount; ++i) {
-    if (subscriptions[i].topic == topic) {
-      subscriptions[i].cb(payload);
-    }
-  }
+  publish(View(topic), View(payload));
 }
 
 }
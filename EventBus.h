@@ -7,15 +7,205 @@
 namespace ESPtools {
 namespace EventBus {
 
-using Handler = std::function<void(const String& payload)>;
+/**
+ * Borrowed text: a pointer and a length, not NUL-terminated. Only valid
+ * for the duration of the call it is passed to; copy it (toString()) to
+ * keep it.
+ */
+struct View {
+  const char* data;
+  size_t      length;
 
-// Subscribe to a topic with a callback
-void subscribe(const String& topic, Handler cb);
+  View() : data(""), length(0) {}
+  View(const char* d, size_t n) : data(d), length(n) {}
+  View(const char* s) : data(s ? s : ""), length(s ? strlen(s) : 0) {}
+  View(const String& s) : data(s.c_str()), length(s.length()) {}
+
+  bool equals(const char* s) const { return strlen(s) == length && memcmp(data, s, length) == 0; }
+  bool operator==(const char* s) const { return equals(s); }
+  String toString() const { return String(data, length); }
+};
+
+// Interned topic handle; see topic().
+using TopicId = uint16_t;
+constexpr TopicId NO_TOPIC = 0xFFFF;
+
+/**
+ * One delivered message. Views point into the publisher's buffers.
+ */
+struct Message {
+  TopicId topic;      ///< NO_TOPIC if the topic was never interned
+  View    topicName;
+  View    payload;
+};
+
+using Handler        = std::function<void(const String& payload)>;
+using MessageHandler = std::function<void(const Message& msg)>;
+
+// Capacity of the subscription pool, the exact-topic index and the
+// wildcard trie.
+constexpr uint16_t MAX_SUBSCRIPTIONS = 128;
+constexpr uint16_t MAX_TOPICS        = 256;
+constexpr uint16_t MAX_FILTER_NODES  = 64;
+
+/**
+ * Intern a topic and return its handle. Resolve handles once at setup;
+ * publishing or subscribing by handle skips hashing and string compares.
+ * @return NO_TOPIC if the topic table is full
+ */
+TopicId topic(View name);
+
+/**
+ * Text of an interned topic (NUL-terminated), or "" for an invalid handle.
+ */
+const char* topicName(TopicId id);
+
+/**
+ * Subscribe to an interned topic. The handler receives borrowed views.
+ * @return false if the subscription pool is full
+ */
+bool subscribe(TopicId topic, MessageHandler cb);
+
+/**
+ * Subscribe to a topic or filter. Filters follow MQTT rules: "+" matches
+ * one level, a trailing "#" matches any number of levels (including
+ * none), and wildcards do not match topics starting with "$".
+ * @return false if a table is full or the filter is malformed
+ */
+bool subscribe(View filter, MessageHandler cb);
+
+/**
+ * Subscribe with a String handler. The payload is copied into a String
+ * for each call; prefer the MessageHandler overloads on hot paths.
+ */
+bool subscribe(const String& topic, Handler cb);
+
+/**
+ * Publish without allocating. Exact subscribers are found through the
+ * topic's handle (or the hash index when published by text) and wildcard
+ * subscribers by walking the filter trie one level per topic segment, so
+ * the cost does not grow with the number of subscriptions.
+ */
+void publish(TopicId topic, View payload);
+void publish(View topic, View payload);
+void publish(const char* topic, const char* payload);
 
 // Publish a message to a topic
 void publish(const String& topic, const String& payload);
 
-// Initialize EventBus
+// Capacity of each deferred-dispatch lane (power of two) and the largest
+// payload it carries.
+constexpr uint16_t QUEUE_DEPTH        = 64;
+constexpr uint8_t  MAX_QUEUED_PAYLOAD = 48;
+
+/**
+ * Dispatch lanes for post(), each with its own queue. loop() always takes
+ * the oldest message of the highest non-empty lane, so control events do
+ * not wait behind a burst of telemetry.
+ */
+enum class Priority : uint8_t { Control, Normal, Telemetry };
+constexpr uint8_t LANES = 3;
+
+/**
+ * What a lane does once it holds its configured depth.
+ */
+enum class Overflow : uint8_t {
+  DropNewest,  ///< post() refuses the new message
+  DropOldest,  ///< post() accepts it; the oldest beyond the depth are discarded at dispatch
+  Coalesce     ///< as DropOldest, and only the newest queued message of a topic is dispatched
+};
+
+/**
+ * Counters of one lane since begin() or resetStats().
+ */
+struct LaneStats {
+  uint32_t enqueued;    ///< accepted by post()
+  uint32_t dispatched;  ///< delivered to subscribers
+  uint32_t dropped;     ///< refused by post() or discarded by the overflow policy
+  uint32_t coalesced;   ///< superseded by a newer message on the same topic
+  uint16_t depth;       ///< messages queued now
+  uint16_t maxDepth;    ///< high-water mark of depth
+};
+
+/**
+ * Configure a lane. All lanes default to DropNewest at QUEUE_DEPTH.
+ * DropOldest and Coalesce keep accepting until the lane's QUEUE_DEPTH
+ * slots are taken, then refuse like DropNewest.
+ * @param depth  messages kept, 1..QUEUE_DEPTH
+ */
+void setLane(Priority lane, uint16_t depth, Overflow policy);
+
+/**
+ * Lane used when posting to a topic (Normal by default).
+ * @return false for an invalid handle
+ */
+bool setPriority(TopicId topic, Priority lane);
+
+/**
+ * Queue a message for deferred dispatch by loop() or the dispatcher task,
+ * on the topic's lane. Lock-free, never blocks, and safe from ISRs and
+ * any task; the payload is copied into a fixed queue slot. Messages from
+ * one publisher on one lane are delivered in order.
+ * @return false if the lane is full or the payload too long (see dropped())
+ */
+bool post(TopicId topic, View payload);
+
+/**
+ * Dispatch queued messages on the calling task, oldest first. Handlers
+ * run here, not in the publisher's context. Does nothing while the
+ * dispatcher task is running.
+ * @param maxMessages upper bound for this call
+ * @return number of messages dispatched
+ */
+size_t loop(size_t maxMessages = QUEUE_DEPTH);
+
+/**
+ * Drain the queue from a dedicated FreeRTOS task (a std::thread on host
+ * builds), woken by post(). Subscribe before starting it: the topic and
+ * subscription tables are not locked against the dispatcher, and its
+ * handlers may run concurrently with a publish() from another task.
+ * @param priority   task priority (ignored on host builds)
+ * @param stackBytes task stack (ignored on host builds)
+ * @return false if already running or the task could not be created
+ */
+bool startDispatcher(uint8_t priority = 5, uint32_t stackBytes = 4096);
+
+/**
+ * Stop the dispatcher task; messages still queued stay for loop().
+ */
+void stopDispatcher();
+
+/**
+ * Messages waiting in all lanes.
+ */
+size_t pending();
+
+/**
+ * Messages refused by post() or discarded by an overflow policy, all lanes.
+ */
+uint32_t dropped();
+
+LaneStats laneStats(Priority lane);
+
+/**
+ * subscribe() calls that failed because a table was full or the filter
+ * malformed.
+ */
+uint32_t subscribeFailures();
+
+/**
+ * Zero the lane counters and subscribeFailures().
+ */
+void resetStats();
+
+/**
+ * Changes with every begin(); lets code that caches topic handles (see
+ * Channel) notice that they were dropped.
+ */
+uint32_t generation();
+
+// Initialize EventBus (drops all subscriptions, topic handles, queued
+// messages and lane settings); not while the dispatcher is running
 void begin();
 
 }
@@ -0,0 +1,148 @@
+#ifndef ESPTOOLS_EVENT_CHANNEL_H
+#define ESPTOOLS_EVENT_CHANNEL_H
+
+#include <Arduino.h>
+#include <functional>
+#include <type_traits>
+#include "EventBus.h"
+
+namespace ESPtools {
+namespace EventBus {
+
+/**
+ * Typed channel for binary events (sensor samples and the like).
+ *
+ * A channel is a type: Channel<T, Key>, where Key is a struct with a
+ * static topic() naming it (see ESPTOOLS_CHANNEL). Every use of the same
+ * type refers to the same handler list, so publishing needs no topic
+ * lookup and subscribers get the struct itself, not text to parse.
+ *
+ * publish() calls the handlers directly with a const reference. post()
+ * copies the struct into the EventBus queue (lanes, overflow policies and
+ * the dispatcher apply) under the internal topic "$ch/<topic>", which
+ * wildcard subscribers do not see. bridge() formats messages onto the
+ * string topic <topic> for consumers outside the device, e.g. MQTT.
+ *
+ * T must be trivially copyable. EventBus::begin() detaches all channels;
+ * set them up after it.
+ */
+template <typename T, typename Key>
+class Channel {
+  static_assert(std::is_trivially_copyable<T>::value, "Channel payloads must be trivially copyable");
+
+public:
+  static constexpr uint8_t MAX_HANDLERS  = 8;
+  static constexpr uint8_t BRIDGE_BUFFER = 96;
+
+  using Handler   = std::function<void(const T &value)>;
+  /** Write the text form of a value into buf; return its length. */
+  using Formatter = size_t (*)(const T &value, char *buf, size_t size);
+
+  /**
+   * Add a handler; it runs in publish() or in the dispatching task for
+   * posted values.
+   * @return false if the handler table is full
+   */
+  static bool subscribe(Handler cb) {
+    if (!cb || !attach() || count() >= MAX_HANDLERS) return false;
+    _handlers[_count++] = std::move(cb);
+    return true;
+  }
+
+  /**
+   * Deliver a value to every handler now, on the calling task.
+   */
+  static void publish(const T &value) {
+    if (_generation != generation()) return;
+    for (uint8_t i = 0; i < _count; ++i) _handlers[i](value);
+  }
+
+  /**
+   * Queue a copy for deferred dispatch; ISR-safe like EventBus::post().
+   * @return false if nothing is subscribed or the lane refused the value
+   */
+  static bool post(const T &value) {
+    static_assert(sizeof(T) <= MAX_QUEUED_PAYLOAD, "Channel payload too large for post()");
+    if (_generation != generation()) return false;
+    return EventBus::post(_topic, View(reinterpret_cast<const char *>(&value), sizeof(T)));
+  }
+
+  /**
+   * Publish the text form of every value on the string topic Key::topic().
+   * Formatting happens only here, once per value.
+   */
+  static bool bridge(Formatter format) {
+    if (!format || !attach()) return false;
+    TopicId text = EventBus::topic(Key::topic());
+    if (text == NO_TOPIC) return false;
+    return subscribe([format, text](const T &value) {
+      char buf[BRIDGE_BUFFER];
+      size_t n = format(value, buf, sizeof(buf));
+      EventBus::publish(text, View(buf, n < sizeof(buf) ? n : sizeof(buf)));
+    });
+  }
+
+  /**
+   * Internal topic carrying posted values, e.g. for EventBus::setPriority().
+   */
+  static TopicId topic() { return attach() ? _topic : NO_TOPIC; }
+
+  static uint8_t handlerCount() { return count(); }
+
+private:
+  static Handler  _handlers[MAX_HANDLERS];
+  static uint8_t  _count;
+  static TopicId  _topic;
+  static uint32_t _generation;
+
+  static uint8_t count() { return _generation == generation() ? _count : 0; }
+
+  // Intern the queue topic once per EventBus::begin().
+  static bool attach() {
+    if (_generation == generation()) return true;
+    for (uint8_t i = 0; i < _count; ++i) _handlers[i] = nullptr;
+    _count = 0;
+    TopicId id = EventBus::topic(String("$ch/") + Key::topic());
+    if (id == NO_TOPIC) return false;
+    if (!EventBus::subscribe(id, [](const Message &msg) {
+          if (msg.payload.length != sizeof(T)) return;
+          T value;
+          memcpy(&value, msg.payload.data, sizeof(T));
+          for (uint8_t i = 0; i < _count; ++i) _handlers[i](value);
+        })) {
+      return false;
+    }
+    _topic = id;
+    _generation = generation();
+    return true;
+  }
+};
+
+template <typename T, typename Key>
+constexpr uint8_t Channel<T, Key>::MAX_HANDLERS;
+template <typename T, typename Key>
+constexpr uint8_t Channel<T, Key>::BRIDGE_BUFFER;
+template <typename T, typename Key>
+typename Channel<T, Key>::Handler Channel<T, Key>::_handlers[Channel<T, Key>::MAX_HANDLERS];
+template <typename T, typename Key>
+uint8_t Channel<T, Key>::_count = 0;
+template <typename T, typename Key>
+TopicId Channel<T, Key>::_topic = NO_TOPIC;
+template <typename T, typename Key>
+uint32_t Channel<T, Key>::_generation = 0;
+
+}
+}
+
+/**
+ * Declare a channel type NAME carrying TYPE under the string topic TOPIC:
+ *   ESPTOOLS_CHANNEL(AdcChannel, AdcSample, "fixture/adc");
+ *   AdcChannel::publish(sample);
+ */
+#define ESPTOOLS_CHANNEL(NAME, TYPE, TOPIC)                        \
+  struct NAME##Key {                                               \
+    static const char *topic() { return TOPIC; }                   \
+  };                                                               \
+  using NAME = ::ESPtools::EventBus::Channel<TYPE, NAME##Key>
+
+#endif
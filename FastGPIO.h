@@ -0,0 +1,95 @@
+#ifndef ESPTOOLS_FAST_GPIO_H
+#define ESPTOOLS_FAST_GPIO_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#endif
+
+namespace ESPtools {
+namespace Util {
+
+/**
+ * Drive a set of output pins high and others low in as few register writes
+ * as the platform allows. On ESP32 this is one write to the W1TS and one to
+ * the W1TC register per bank; on a host build it goes to the simulator; on
+ * other cores it falls back to digitalWrite().
+ * @param setMask   Bit n set drives GPIO n high
+ * @param clearMask Bit n set drives GPIO n low
+ */
+inline void writePinMasks(uint64_t setMask, uint64_t clearMask) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (uint32_t(setMask))   REG_WRITE(GPIO_OUT_W1TS_REG, uint32_t(setMask));
+  if (uint32_t(clearMask)) REG_WRITE(GPIO_OUT_W1TC_REG, uint32_t(clearMask));
+#ifdef GPIO_OUT1_W1TS_REG
+  if (setMask >> 32)   REG_WRITE(GPIO_OUT1_W1TS_REG, uint32_t(setMask >> 32));
+  if (clearMask >> 32) REG_WRITE(GPIO_OUT1_W1TC_REG, uint32_t(clearMask >> 32));
+#endif
+#elif !defined(ARDUINO)
+  sim::writePinMasks(setMask, clearMask);
+#else
+  for (uint8_t pin = 0; pin < 64; ++pin) {
+    uint64_t bit = uint64_t(1) << pin;
+    if (setMask & bit)        ::digitalWrite(pin, HIGH);
+    else if (clearMask & bit) ::digitalWrite(pin, LOW);
+  }
+#endif
+}
+
+/**
+ * Up to eight output pins written together as the bits of one value, e.g.
+ * the address lines of an analog mux.
+ */
+class PinGroup {
+public:
+  static constexpr uint8_t MAX_PINS = 8;
+
+  PinGroup() : _count(0), _all(0) {}
+
+  /**
+   * Append a pin; it becomes the next higher bit of the value.
+   * @param pin GPIO number (0-63)
+   * @return false if the group is full or the pin is out of range
+   */
+  bool add(uint8_t pin) {
+    if (_count >= MAX_PINS || pin > 63) return false;
+    _pins[_count] = pin;
+    _masks[_count] = uint64_t(1) << pin;
+    _all |= _masks[_count];
+    ++_count;
+    return true;
+  }
+
+  /**
+   * Configure all pins as outputs.
+   */
+  void begin() {
+    for (uint8_t i = 0; i < _count; ++i) ::pinMode(_pins[i], OUTPUT);
+  }
+
+  /**
+   * Drive bit i of value onto the i-th pin added.
+   */
+  void write(uint8_t value) {
+    uint64_t set = 0;
+    for (uint8_t i = 0; i < _count; ++i) {
+      if (value & (1u << i)) set |= _masks[i];
+    }
+    writePinMasks(set, _all & ~set);
+  }
+
+  uint8_t size() const { return _count; }
+
+private:
+  uint8_t  _pins[MAX_PINS];
+  uint64_t _masks[MAX_PINS];
+  uint8_t  _count;
+  uint64_t _all;
+};
+
+}
+}
+
+#endif
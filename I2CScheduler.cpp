@@ -0,0 +1,197 @@
+#include "I2CScheduler.h"
+
+namespace ESPtools {
+namespace Mux {
+
+static constexpr uint8_t NO_CHANNEL = 0xFF;
+
+static void addAddress(uint32_t *set, uint8_t address) {
+  set[(address >> 5) & 0x03] |= 1UL << (address & 0x1F);
+}
+
+I2CScheduler::I2CScheduler(TwoWire &wire)
+  : _wire(wire), _deviceCount(0), _channelCount(0), _groupCount(0), _pendingCount(0),
+    _multiChannel(true), _groupsValid(false), _errors(0) {}
+
+int8_t I2CScheduler::addDevice(uint8_t address, PCA9548A *mux, uint8_t bus) {
+  if (_deviceCount >= MAX_DEVICES) return -1;
+  bus &= 0x07;
+
+  uint8_t channel = NO_CHANNEL;
+  if (mux) {
+    for (uint8_t c = 0; c < _channelCount; ++c) {
+      if (_channels[c].mux == mux && _channels[c].bus == bus) channel = c;
+    }
+    if (channel == NO_CHANNEL) {
+      if (_channelCount >= MAX_CHANNELS) return -1;
+      channel = _channelCount++;
+      Channel &c = _channels[channel];
+      c.mux = mux;
+      c.bus = bus;
+      memset(c.addresses, 0, sizeof(c.addresses));
+    }
+    addAddress(_channels[channel].addresses, address);
+    _groupsValid = false;
+  }
+
+  _devices[_deviceCount].address = address & 0x7F;
+  _devices[_deviceCount].channel = channel;
+  return int8_t(_deviceCount++);
+}
+
+void I2CScheduler::setMultiChannel(bool enable) {
+  _multiChannel = enable;
+  _groupsValid = false;
+}
+
+bool I2CScheduler::write(int8_t device, const uint8_t *data, uint8_t len, Callback cb) {
+  if (len == 0) return false;
+  return writeRead(device, data, len, 0, nullptr, cb);
+}
+
+bool I2CScheduler::writeRead(int8_t device, const uint8_t *tx, uint8_t txLen, uint8_t rxLen,
+                             uint8_t *dest, Callback cb) {
+  if (device < 0 || device >= _deviceCount) return false;
+  if (txLen > MAX_WRITE || rxLen > MAX_READ || _pendingCount >= MAX_PENDING) return false;
+  Transaction &t = _pending[_pendingCount++];
+  t.device = device;
+  t.txLen = txLen;
+  t.rxLen = rxLen;
+  if (txLen) memcpy(t.tx, tx, txLen);
+  t.dest = dest;
+  t.cb = cb;
+  return true;
+}
+
+uint8_t I2CScheduler::run() {
+  if (!_groupsValid) buildGroups();
+  // Callbacks may queue more; those wait for the next run().
+  uint8_t count = _pendingCount;
+  uint8_t done = 0;
+
+  // Main-bus devices are reachable whatever the muxes select; move any
+  // enabled channel out of the way only if it shadows the address.
+  for (uint8_t i = 0; i < count; ++i) {
+    Transaction &t = _pending[i];
+    if (_devices[t.device].channel != NO_CHANNEL) continue;
+    uint32_t set[4] = { 0, 0, 0, 0 };
+    addAddress(set, _devices[t.device].address);
+    for (uint8_t c = 0; c < _channelCount; ++c) {
+      const Channel &ch = _channels[c];
+      uint8_t bit = 1 << ch.bus;
+      if ((ch.mux->enabledMask() & bit) && collides(ch.addresses, set)) {
+        ch.mux->selectMask(ch.mux->enabledMask() & ~bit);
+      }
+    }
+    execute(t);
+    ++done;
+  }
+
+  // Then one selection per group, serving groups that are already selected first.
+  for (uint8_t pass = 0; pass < 2; ++pass) {
+    for (uint8_t g = 0; g < _groupCount; ++g) {
+      const Group &group = _groups[g];
+      bool selected = group.mux->enabledMask() == group.mask;
+      if (selected != (pass == 0)) continue;
+
+      bool first = true;
+      for (uint8_t i = 0; i < count; ++i) {
+        Transaction &t = _pending[i];
+        uint8_t channel = _devices[t.device].channel;
+        if (channel == NO_CHANNEL || _channels[channel].group != g) continue;
+        if (first) {
+          group.mux->lock();
+          selectGroup(group);
+          first = false;
+        }
+        execute(t);
+        ++done;
+      }
+      if (!first) group.mux->unlock();
+    }
+  }
+
+  for (uint8_t i = count; i < _pendingCount; ++i) _pending[i - count] = std::move(_pending[i]);
+  _pendingCount -= count;
+  return done;
+}
+
+void I2CScheduler::buildGroups() {
+  _groupCount = 0;
+  for (uint8_t c = 0; c < _channelCount; ++c) {
+    Channel &ch = _channels[c];
+    uint8_t g = NO_CHANNEL;
+    if (_multiChannel) {
+      for (uint8_t k = 0; k < _groupCount; ++k) {
+        if (_groups[k].mux == ch.mux && !collides(_groups[k].addresses, ch.addresses)) {
+          g = k;
+          break;
+        }
+      }
+    }
+    if (g == NO_CHANNEL) {
+      g = _groupCount++;
+      _groups[g].mux = ch.mux;
+      _groups[g].mask = 0;
+      memset(_groups[g].addresses, 0, sizeof(_groups[g].addresses));
+    }
+    _groups[g].mask |= 1 << ch.bus;
+    for (uint8_t w = 0; w < 4; ++w) _groups[g].addresses[w] |= ch.addresses[w];
+    ch.group = g;
+  }
+  _groupsValid = true;
+}
+
+void I2CScheduler::selectGroup(const Group &g) {
+  // Channels still enabled on other muxes must not answer for our addresses.
+  for (uint8_t c = 0; c < _channelCount; ++c) {
+    const Channel &ch = _channels[c];
+    uint8_t bit = 1 << ch.bus;
+    if (ch.mux == g.mux || !(ch.mux->enabledMask() & bit)) continue;
+    if (collides(ch.addresses, g.addresses)) {
+      ch.mux->selectMask(ch.mux->enabledMask() & ~bit);
+    }
+  }
+  g.mux->selectMask(g.mask);
+}
+
+void I2CScheduler::execute(Transaction &t) {
+  const Device &device = _devices[t.device];
+  uint8_t address = device.address;
+  uint8_t route = BusStats::MAIN_BUS;
+  if (device.channel != NO_CHANNEL) {
+    const Channel &ch = _channels[device.channel];
+    route = BusStats::route(ch.mux->address(), ch.bus);
+  }
+  BusStats::Probe probe(BusStats::I2C, address, route);
+  uint8_t buf[MAX_READ];
+  uint8_t n = 0;
+  uint8_t status = 0;
+
+  if (t.txLen || !t.rxLen) {
+    _wire.beginTransmission(address);
+    for (uint8_t i = 0; i < t.txLen; ++i) _wire.write(t.tx[i]);
+    status = _wire.endTransmission(t.rxLen == 0);
+    probe.transaction(t.txLen, status == 0);
+  }
+  if (status == 0 && t.rxLen) {
+    n = _wire.requestFrom(int(address), int(t.rxLen));
+    if (n > t.rxLen) n = t.rxLen;
+    for (uint8_t i = 0; i < n; ++i) buf[i] = _wire.read();
+    if (n != t.rxLen) status = 4;
+    probe.transaction(n, status == 0);
+    if (t.dest) memcpy(t.dest, buf, n);
+  }
+
+  if (status) ++_errors;
+  if (t.cb) t.cb(status, t.rxLen ? buf : nullptr, n);
+  t.device = -1;
+  t.cb = nullptr;
+}
+
+bool I2CScheduler::collides(const uint32_t *a, const uint32_t *b) {
+  return (a[0] & b[0]) | (a[1] & b[1]) | (a[2] & b[2]) | (a[3] & b[3]);
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef ESPTOOLS_I2CSCHEDULER_H
+#define ESPTOOLS_I2CSCHEDULER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <functional>
+#include "PCA9548A.h"
+
+namespace ESPtools {
+namespace Mux {
+
+/**
+ * Queued I2C transactions for a bus with devices behind PCA9548A muxes.
+ *
+ * Devices are registered once with their mux and downstream bus. Queued
+ * transactions are held until run(), which executes them grouped by mux
+ * channel so each channel is selected once per run, starting with the
+ * channels already enabled. Transactions to the same device keep their
+ * queued order.
+ *
+ * With multi-channel selection enabled, channels of one mux whose device
+ * addresses do not collide are merged into a single mask and served
+ * together, so e.g. eight sensors with distinct addresses on eight
+ * channels need one mux write instead of eight.
+ */
+class I2CScheduler {
+public:
+  static constexpr uint8_t MAX_DEVICES  = 32;
+  static constexpr uint8_t MAX_CHANNELS = 16;
+  static constexpr uint8_t MAX_PENDING  = 32;
+  static constexpr uint8_t MAX_WRITE    = 8;
+  static constexpr uint8_t MAX_READ     = 8;
+
+  /**
+   * Completion callback.
+   * @param status 0 on success, else the Wire error code (4 = short read)
+   * @param data   bytes read (nullptr for write-only transactions)
+   * @param len    number of bytes read
+   */
+  using Callback = std::function<void(uint8_t status, const uint8_t *data, uint8_t len)>;
+
+  explicit I2CScheduler(TwoWire &wire = Wire);
+
+  /**
+   * Register a device.
+   * @param address 7-bit I2C address
+   * @param mux     PCA9548A the device sits behind, or nullptr for the main bus
+   * @param bus     downstream bus on that mux (0-7)
+   * @return device handle, or -1 if full
+   */
+  int8_t addDevice(uint8_t address, PCA9548A *mux = nullptr, uint8_t bus = 0);
+
+  /**
+   * Allow merging collision-free channels into one mux mask (default on).
+   * Each enabled channel adds bus capacitance; turn off for long cables.
+   */
+  void setMultiChannel(bool enable);
+
+  /**
+   * Queue a write.
+   * @return false if the queue is full or arguments are invalid
+   */
+  bool write(int8_t device, const uint8_t *data, uint8_t len, Callback cb = nullptr);
+
+  /**
+   * Queue a write (e.g. register pointer) followed by a repeated-start read.
+   * txLen may be 0 for a plain read.
+   * @param dest optional buffer that receives the bytes read
+   */
+  bool writeRead(int8_t device, const uint8_t *tx, uint8_t txLen, uint8_t rxLen,
+                 uint8_t *dest = nullptr, Callback cb = nullptr);
+
+  /**
+   * Execute every queued transaction. Transactions queued by callbacks
+   * during the call are kept for the next run().
+   * @return number of transactions executed
+   */
+  uint8_t run();
+
+  uint8_t pending() const { return _pendingCount; }
+
+  /**
+   * Transactions that failed (NACK or short read) since construction.
+   */
+  uint32_t errorCount() const { return _errors; }
+
+private:
+  struct Device {
+    uint8_t address;
+    uint8_t channel;   // index into _channels, 0xFF on the main bus
+  };
+
+  struct Channel {
+    PCA9548A *mux;
+    uint8_t   bus;
+    uint8_t   group;
+    uint32_t  addresses[4];
+  };
+
+  struct Group {
+    PCA9548A *mux;
+    uint8_t   mask;
+    uint32_t  addresses[4];
+  };
+
+  struct Transaction {
+    int8_t   device;
+    uint8_t  txLen;
+    uint8_t  rxLen;
+    uint8_t  tx[MAX_WRITE];
+    uint8_t *dest;
+    Callback cb;
+  };
+
+  TwoWire    &_wire;
+  Device      _devices[MAX_DEVICES];
+  Channel     _channels[MAX_CHANNELS];
+  Group       _groups[MAX_CHANNELS];
+  Transaction _pending[MAX_PENDING];
+  uint8_t     _deviceCount;
+  uint8_t     _channelCount;
+  uint8_t     _groupCount;
+  uint8_t     _pendingCount;
+  bool        _multiChannel;
+  bool        _groupsValid;
+  uint32_t    _errors;
+
+  void buildGroups();
+  void selectGroup(const Group &g);
+  void execute(Transaction &t);
+  static bool collides(const uint32_t *a, const uint32_t *b);
+};
+
+}
+}
+
+#endif
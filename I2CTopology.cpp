@@ -0,0 +1,265 @@
+#include "I2CTopology.h"
+#include <Preferences.h>
+
+namespace ESPtools {
+namespace Mux {
+
+constexpr uint8_t I2CTopology::MAX_MUXES;
+constexpr uint8_t I2CTopology::MAX_NODES;
+constexpr uint8_t I2CTopology::MAIN_BUS;
+
+// Bump when the stored layout of I2CNode changes.
+static constexpr uint8_t FORMAT_VERSION = 1;
+
+I2CTopology::I2CTopology(TwoWire &wire)
+  : _wire(wire), _muxCount(0), _count(0), _parallel(8), _fromCache(false), _probes(0) {}
+
+bool I2CTopology::addMux(PCA9548A &mux) {
+  if (_muxCount >= MAX_MUXES) return false;
+  _muxes[_muxCount] = &mux;
+  _muxPresent[_muxCount] = false;
+  ++_muxCount;
+  return true;
+}
+
+void I2CTopology::setParallelChannels(uint8_t channels) {
+  _parallel = 1;
+  while (_parallel < 8 && uint8_t(_parallel << 1) <= channels) _parallel <<= 1;
+}
+
+uint8_t I2CTopology::begin(const char *ns) {
+  uint32_t probes = 0;
+  _fromCache = false;
+  if (load(ns)) {
+    _fromCache = verify();
+    probes = _probes;
+  }
+  if (!_fromCache) {
+    discover();
+    save(ns);
+    _probes += probes;
+  }
+  return _count;
+}
+
+uint8_t I2CTopology::discover() {
+  _probes = 0;
+  _count = 0;
+  beginMuxes();
+
+  for (uint8_t a = 0x08; a <= 0x77; ++a) {
+    if (probe(a)) addNode(a, MAIN_BUS, 0);
+  }
+
+  for (uint8_t m = 0; m < _muxCount; ++m) {
+    if (!_muxPresent[m]) continue;
+    PCA9548A &mux = *_muxes[m];
+    mux.lock();
+    for (uint8_t first = 0; first < 8; first += _parallel) {
+      uint8_t mask = uint8_t(((1u << _parallel) - 1) << first);
+      select(m, mask);
+      for (uint8_t a = 0x08; a <= 0x77; ++a) {
+        if (onMainBus(a) || !probe(a)) continue;
+        resolve(m, a, mask);
+        select(m, mask);
+      }
+    }
+    select(m, 0);
+    mux.unlock();
+  }
+
+  // Group by position so verify() selects each bus once.
+  for (uint8_t i = 1; i < _count; ++i) {
+    I2CNode n = _nodes[i];
+    uint16_t key = uint16_t(n.mux) << 3 | n.bus;
+    uint8_t j = i;
+    while (j > 0 && (uint16_t(_nodes[j - 1].mux) << 3 | _nodes[j - 1].bus) > key) {
+      _nodes[j] = _nodes[j - 1];
+      --j;
+    }
+    _nodes[j] = n;
+  }
+  return _count;
+}
+
+bool I2CTopology::verify() {
+  _probes = 0;
+  beginMuxes();
+  bool ok = true;
+  for (uint8_t i = 0; i < _count && ok; ++i) {
+    const I2CNode &n = _nodes[i];
+    if (n.mux == MAIN_BUS) {
+      ok = probe(n.address);
+      continue;
+    }
+    if (n.mux >= _muxCount || !_muxPresent[n.mux]) {
+      ok = false;
+      break;
+    }
+    select(n.mux, uint8_t(1 << n.bus));
+    ok = probe(n.address);
+  }
+  closeMuxes();
+  return ok;
+}
+
+bool I2CTopology::load(const char *ns) {
+  Preferences prefs;
+  if (!prefs.begin(ns, true)) return false;
+  uint8_t muxAddr[MAX_MUXES];
+  bool ok = prefs.getUChar("ver", 0) == FORMAT_VERSION &&
+            prefs.getBytesLength("muxes") == _muxCount &&
+            prefs.getBytes("muxes", muxAddr, sizeof(muxAddr)) == _muxCount;
+  for (uint8_t m = 0; ok && m < _muxCount; ++m) ok = muxAddr[m] == _muxes[m]->address();
+
+  size_t len = ok ? prefs.getBytesLength("nodes") : 0;
+  if (ok && (len % sizeof(I2CNode) != 0 || len > sizeof(_nodes))) ok = false;
+  if (ok) {
+    prefs.getBytes("nodes", _nodes, len);
+    _count = uint8_t(len / sizeof(I2CNode));
+  }
+  prefs.end();
+  return ok;
+}
+
+bool I2CTopology::save(const char *ns) const {
+  Preferences prefs;
+  if (!prefs.begin(ns, false)) return false;
+  uint8_t muxAddr[MAX_MUXES];
+  for (uint8_t m = 0; m < _muxCount; ++m) muxAddr[m] = _muxes[m]->address();
+  prefs.putUChar("ver", FORMAT_VERSION);
+  prefs.putBytes("muxes", muxAddr, _muxCount);
+  bool ok = prefs.putBytes("nodes", _nodes, _count * sizeof(I2CNode)) == _count * sizeof(I2CNode);
+  prefs.end();
+  return ok;
+}
+
+int8_t I2CTopology::find(I2CDeviceType type, uint8_t n) const {
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_nodes[i].type == type && n-- == 0) return int8_t(i);
+  }
+  return -1;
+}
+
+bool I2CTopology::contains(uint8_t address, const PCA9548A *mux, uint8_t bus) const {
+  for (uint8_t i = 0; i < _count; ++i) {
+    const I2CNode &n = _nodes[i];
+    if (n.address != address) continue;
+    if (!mux && n.mux == MAIN_BUS) return true;
+    if (mux && n.mux != MAIN_BUS && _muxes[n.mux] == mux && n.bus == (bus & 0x07)) return true;
+  }
+  return false;
+}
+
+const char *I2CTopology::typeName(I2CDeviceType type) {
+  switch (type) {
+    case I2CDeviceType::ADS1115:     return "ADS1115";
+    case I2CDeviceType::PCF8575:     return "PCF8575";
+    case I2CDeviceType::DS3231:      return "DS3231";
+    case I2CDeviceType::LCDBackpack: return "LCD";
+    case I2CDeviceType::PCA9548A:    return "PCA9548A";
+    default:                         return "unknown";
+  }
+}
+
+bool I2CTopology::probe(uint8_t address) {
+  ++_probes;
+  _wire.beginTransmission(address);
+  return _wire.endTransmission() == 0;
+}
+
+bool I2CTopology::onMainBus(uint8_t address) const {
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_nodes[i].mux == MAIN_BUS && _nodes[i].address == address) return true;
+  }
+  return false;
+}
+
+void I2CTopology::beginMuxes() {
+  // begin() reads the control register back, so it doubles as a probe.
+  for (uint8_t m = 0; m < _muxCount; ++m) {
+    ++_probes;
+    _muxPresent[m] = _muxes[m]->begin();
+  }
+  closeMuxes();
+}
+
+void I2CTopology::closeMuxes() {
+  for (uint8_t m = 0; m < _muxCount; ++m) {
+    if (_muxPresent[m]) select(m, 0);
+  }
+}
+
+void I2CTopology::select(uint8_t mux, uint8_t mask) {
+  // Only one mux may be open, or its devices would answer for another's.
+  for (uint8_t m = 0; m < _muxCount; ++m) {
+    if (m == mux || !_muxPresent[m] || _muxes[m]->enabledMask() == 0) continue;
+    uint32_t w = _muxes[m]->writeCount();
+    _muxes[m]->disableAll();
+    _probes += _muxes[m]->writeCount() - w;
+  }
+  uint32_t w = _muxes[mux]->writeCount();
+  _muxes[mux]->selectMask(mask);
+  _probes += _muxes[mux]->writeCount() - w;
+}
+
+void I2CTopology::resolve(uint8_t mux, uint8_t address, uint8_t mask) {
+  // mask is known to answer; split it until single channels remain.
+  if (!(mask & (mask - 1))) {
+    uint8_t bus = 0;
+    while (!(mask & (1 << bus))) ++bus;
+    addNode(address, mux, bus);
+    return;
+  }
+  uint8_t width = 0;
+  for (uint8_t m = mask; m; m &= m - 1) ++width;
+  uint8_t low = 0;
+  for (uint8_t bit = 0, n = 0; bit < 8 && n < width / 2; ++bit) {
+    if (mask & (1 << bit)) {
+      low |= (1 << bit);
+      ++n;
+    }
+  }
+  uint8_t high = mask & ~low;
+  select(mux, low);
+  bool inLow = probe(address);
+  if (inLow) resolve(mux, address, low);
+  // If the low half was empty the high half must answer; skip the probe.
+  select(mux, high);
+  if (!inLow || probe(address)) resolve(mux, address, high);
+}
+
+void I2CTopology::addNode(uint8_t address, uint8_t mux, uint8_t bus) {
+  if (_count >= MAX_NODES) return;
+  I2CNode &n = _nodes[_count++];
+  n.address = address;
+  n.mux     = mux;
+  n.bus     = bus;
+  n.type    = classify(address, mux == MAIN_BUS);
+}
+
+I2CDeviceType I2CTopology::classify(uint8_t address, bool mainBus) {
+  if (address >= 0x48 && address <= 0x4B) return I2CDeviceType::ADS1115;
+  if (address >= 0x20 && address <= 0x26) {
+    return isPCF8575(address) ? I2CDeviceType::PCF8575 : I2CDeviceType::Unknown;
+  }
+  if (address == 0x27 || (address >= 0x38 && address <= 0x3F)) return I2CDeviceType::LCDBackpack;
+  if (address == 0x68) return I2CDeviceType::DS3231;
+  if (mainBus && address >= 0x70 && address <= 0x77) return I2CDeviceType::PCA9548A;
+  return I2CDeviceType::Unknown;
+}
+
+bool I2CTopology::isPCF8575(uint8_t address) {
+  // The device is selected when addNode() runs. A PCF8575 has no registers
+  // and repeats P0, P1 on every read, while register-based parts in the same
+  // range (e.g. MCP23017) auto-increment. Nothing is written, so outputs
+  // stay as they are; a pin changing mid-read gives a false Unknown.
+  ++_probes;
+  if (_wire.requestFrom(int(address), 4) != 4) return false;
+  uint8_t b[4];
+  for (uint8_t i = 0; i < 4; ++i) b[i] = uint8_t(_wire.read());
+  return b[0] == b[2] && b[1] == b[3];
+}
+
+}
+}
\ No newline at end of file
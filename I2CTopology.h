@@ -0,0 +1,153 @@
+#ifndef ESPTOOLS_I2C_TOPOLOGY_H
+#define ESPTOOLS_I2C_TOPOLOGY_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "PCA9548A.h"
+
+namespace ESPtools {
+namespace Mux {
+
+enum class I2CDeviceType : uint8_t {
+  Unknown,
+  ADS1115,      ///< 0x48-0x4B
+  PCF8575,      ///< 0x20-0x26
+  DS3231,       ///< 0x68
+  LCDBackpack,  ///< 0x27, 0x38-0x3F (PCF8574/PCF8574A LCD adapters)
+  PCA9548A      ///< 0x70-0x77 on the main bus
+};
+
+/**
+ * One device found on the bus tree.
+ */
+struct I2CNode {
+  uint8_t       address;
+  uint8_t       mux;      ///< index of the PCA9548A (addMux() order), or I2CTopology::MAIN_BUS
+  uint8_t       bus;      ///< downstream bus on that mux
+  I2CDeviceType type;
+};
+
+/**
+ * Discovers the devices on an I2C bus and the downstream buses of its
+ * PCA9548As, and caches the result in NVS (Preferences).
+ *
+ * A full discovery scans the main bus with all muxes off, then opens
+ * several channels of one mux at a time: an address that does not answer
+ * is absent on all of them, and only answering addresses are narrowed down
+ * by halving the channel mask. On later boots begin() only probes the
+ * cached devices and falls back to a full discovery if one is missing.
+ *
+ * Devices are classified by address; 0x20-0x26 also have to pass a
+ * read-only PCF8575 check (see isPCF8575()) or are reported as Unknown.
+ * Addresses that answer on the main bus are not searched behind the muxes,
+ * and muxes behind muxes are not walked.
+ */
+class I2CTopology {
+public:
+  static constexpr uint8_t MAX_MUXES = 8;
+  static constexpr uint8_t MAX_NODES = 64;
+  static constexpr uint8_t MAIN_BUS  = 0xFF;
+
+  explicit I2CTopology(TwoWire &wire = Wire);
+
+  /**
+   * Register a PCA9548A on the main bus. Its index in I2CNode::mux follows
+   * the order of the calls.
+   * @return false if the table is full
+   */
+  bool addMux(PCA9548A &mux);
+
+  /**
+   * Channels opened together while searching behind a mux (1, 2, 4 or 8,
+   * default 8). Lower it if the combined bus capacitance is too high; 1
+   * gives a plain channel-by-channel scan.
+   */
+  void setParallelChannels(uint8_t channels);
+
+  /**
+   * Verify the topology cached in NVS; if it is missing, stale or a device
+   * does not answer, run discover() and store the new map.
+   * @param ns Preferences namespace
+   * @return number of devices found
+   */
+  uint8_t begin(const char *ns = "i2c-topo");
+
+  /**
+   * Full scan of the main bus and every mux channel.
+   * @return number of devices found
+   */
+  uint8_t discover();
+
+  /**
+   * Probe every device of the current map once.
+   * @return true if all of them answered
+   */
+  bool verify();
+
+  /**
+   * Load the map from NVS. Fails if it was stored for a different mux list.
+   */
+  bool load(const char *ns = "i2c-topo");
+
+  /**
+   * Store the current map in NVS.
+   */
+  bool save(const char *ns = "i2c-topo") const;
+
+  /**
+   * True if the last begin() was satisfied by the cached map.
+   */
+  bool fromCache() const { return _fromCache; }
+
+  uint8_t nodeCount() const { return _count; }
+  const I2CNode &node(uint8_t i) const { return _nodes[i < _count ? i : 0]; }
+
+  /**
+   * Index of the n-th device of a type, or -1.
+   */
+  int8_t find(I2CDeviceType type, uint8_t n = 0) const;
+
+  /**
+   * Whether a device was found at this address and position.
+   * @param mux nullptr for the main bus
+   */
+  bool contains(uint8_t address, const PCA9548A *mux = nullptr, uint8_t bus = 0) const;
+
+  /**
+   * PCA9548A with the given index, for I2CNode::mux.
+   */
+  PCA9548A *mux(uint8_t index) const { return index < _muxCount ? _muxes[index] : nullptr; }
+
+  /**
+   * I2C transactions used by the last begin(), discover() or verify().
+   */
+  uint32_t probeCount() const { return _probes; }
+
+  static const char *typeName(I2CDeviceType type);
+
+private:
+  TwoWire  &_wire;
+  PCA9548A *_muxes[MAX_MUXES];
+  bool      _muxPresent[MAX_MUXES];
+  I2CNode   _nodes[MAX_NODES];
+  uint8_t   _muxCount;
+  uint8_t   _count;
+  uint8_t   _parallel;
+  bool      _fromCache;
+  uint32_t  _probes;
+
+  bool probe(uint8_t address);
+  bool onMainBus(uint8_t address) const;
+  void beginMuxes();
+  void closeMuxes();
+  void select(uint8_t mux, uint8_t mask);
+  void resolve(uint8_t mux, uint8_t address, uint8_t mask);
+  void addNode(uint8_t address, uint8_t mux, uint8_t bus);
+  I2CDeviceType classify(uint8_t address, bool mainBus);
+  bool isPCF8575(uint8_t address);
+};
+
+}
+}
+
+#endif
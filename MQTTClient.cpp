@@ -12,11 +12,22 @@ static const char*      _userG           = nullptr;
 static const char*      _passG           = nullptr;
 static std::vector<String> _subscribedTopics;
 
+// Copy of the message being dispatched. topic and payload point into
+// PubSubClient's buffer, which a handler calling publish() overwrites.
+static char _inbound[MQTT_MAX_PACKET_SIZE];
+
 static void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  String t(topic);
-  String p;
-  for (unsigned int i = 0; i < length; ++i) p += (char)payload[i];
-  EventBus::publish(t, p);
+  size_t topicLen = strlen(topic);
+  if (topicLen + length > sizeof(_inbound)) {
+    // Buffer enlarged with setBufferSize(): fall back to copying into Strings.
+    String p(reinterpret_cast<const char*>(payload), length);
+    EventBus::publish(String(topic), p);
+    return;
+  }
+  memcpy(_inbound, topic, topicLen);
+  memcpy(_inbound + topicLen, payload, length);
+  EventBus::publish(EventBus::View(_inbound, topicLen),
+                    EventBus::View(_inbound + topicLen, length));
 }
 
 void begin(PubSubClient& client, const char* broker, uint16_t port) {
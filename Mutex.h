@@ -0,0 +1,67 @@
+#ifndef ESPTOOLS_MUTEX_H
+#define ESPTOOLS_MUTEX_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif !defined(ARDUINO)
+#include <mutex>
+#endif
+
+namespace ESPtools {
+namespace Util {
+
+/**
+ * Recursive mutex for sharing a bus between tasks. A FreeRTOS recursive
+ * mutex on ESP32, std::recursive_mutex on a host build, and a no-op on
+ * single-threaded Arduino cores. Not for use from ISRs.
+ */
+class Mutex {
+public:
+#if defined(ARDUINO_ARCH_ESP32)
+  Mutex() : _handle(xSemaphoreCreateRecursiveMutex()) {}
+  ~Mutex() { if (_handle) vSemaphoreDelete(_handle); }
+  void lock()   { xSemaphoreTakeRecursive(_handle, portMAX_DELAY); }
+  void unlock() { xSemaphoreGiveRecursive(_handle); }
+#elif !defined(ARDUINO)
+  Mutex() {}
+  void lock()   { _mutex.lock(); }
+  void unlock() { _mutex.unlock(); }
+#else
+  Mutex() {}
+  void lock()   {}
+  void unlock() {}
+#endif
+
+  Mutex(const Mutex &) = delete;
+  Mutex &operator=(const Mutex &) = delete;
+
+private:
+#if defined(ARDUINO_ARCH_ESP32)
+  SemaphoreHandle_t _handle;
+#elif !defined(ARDUINO)
+  std::recursive_mutex _mutex;
+#endif
+};
+
+/**
+ * Holds a Mutex for the lifetime of the object.
+ */
+class Lock {
+public:
+  explicit Lock(Mutex &mutex) : _mutex(mutex) { _mutex.lock(); }
+  ~Lock() { _mutex.unlock(); }
+
+  Lock(const Lock &) = delete;
+  Lock &operator=(const Lock &) = delete;
+
+private:
+  Mutex &_mutex;
+};
+
+}
+}
+
+#endif
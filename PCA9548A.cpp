@@ -3,37 +3,103 @@
 namespace ESPtools {
 namespace Mux {
 
+constexpr uint8_t PCA9548A::MAX_MUXES;
+
+static PCA9548A *muxes[PCA9548A::MAX_MUXES];
+
+// One lock per TwoWire, shared by its muxes. Past MAX_WIRES the last lock
+// is shared; that only serializes more than needed.
+static Util::Mutex &wireLock(TwoWire &wire) {
+  static constexpr uint8_t MAX_WIRES = 4;
+  static TwoWire *wires[MAX_WIRES];
+  static Util::Mutex locks[MAX_WIRES];
+  for (uint8_t i = 0; i < MAX_WIRES; ++i) {
+    if (!wires[i]) wires[i] = &wire;
+    if (wires[i] == &wire) return locks[i];
+  }
+  return locks[MAX_WIRES - 1];
+}
+
 PCA9548A::PCA9548A(uint8_t address, TwoWire &wire)
-  : _wire(wire), _address(address), _mask(0x00) {}
+  : _wire(wire), _address(address), _mask(0x00), _known(false), _writes(0),
+    _lock(wireLock(wire)) {
+  for (uint8_t i = 0; i < 8; ++i) {
+    _channels[i]._mux = this;
+    _channels[i]._bus = i;
+  }
+  for (uint8_t i = 0; i < MAX_MUXES; ++i) {
+    if (!muxes[i]) {
+      muxes[i] = this;
+      break;
+    }
+  }
+}
+
+PCA9548A::~PCA9548A() {
+  for (uint8_t i = 0; i < MAX_MUXES; ++i) {
+    if (muxes[i] == this) muxes[i] = nullptr;
+  }
+}
 
 bool PCA9548A::begin() {
   _wire.begin();
-  _wire.beginTransmission(_address);
-  if (_wire.endTransmission() == 0) {
-    _mask = 0x00;
+  Util::Lock lock(_lock);
+  BusStats::Probe probe(BusStats::I2C, _address);
+  // The mux keeps its state across an MCU reset, so read it rather than assume 0.
+  bool ok = _wire.requestFrom(int(_address), 1) == 1;
+  probe.transaction(1, ok);
+  if (ok) {
+    _mask = _wire.read();
+    _known = true;
     return true;
   }
+  _known = false;
   return false;
 }
 
 void PCA9548A::selectBus(uint8_t bus) {
   bus &= 0x07;
-  _mask = (1 << bus);
+  selectMask(1 << bus);
+}
+
+bool PCA9548A::selectMask(uint8_t mask) {
+  Util::Lock lock(_lock);
+  if (_known && mask == _mask) return true;
+  BusStats::Probe probe(BusStats::I2C, _address);
   _wire.beginTransmission(_address);
-  _wire.write(_mask);
-  _wire.endTransmission();
+  _wire.write(mask);
+  bool ok = _wire.endTransmission() == 0;
+  probe.transaction(1, ok);
+  ++_writes;
+  _mask = mask;
+  _known = ok;
+  return ok;
 }
 
 void PCA9548A::disableAll() {
-  _mask = 0x00;
-  _wire.beginTransmission(_address);
-  _wire.write(_mask);
-  _wire.endTransmission();
+  selectMask(0x00);
 }
 
 uint8_t PCA9548A::enabledMask() const {
   return _mask;
 }
 
+void PCA9548A::closeOthers() {
+  for (uint8_t i = 0; i < MAX_MUXES; ++i) {
+    PCA9548A *other = muxes[i];
+    if (other && other != this && &other->_wire == &_wire && other->_mask) other->disableAll();
+  }
+}
+
+void PCA9548A::Channel::acquire() {
+  _mux->lock();
+  _mux->closeOthers();
+  _mux->selectBus(_bus);
+}
+
+void PCA9548A::Channel::release() {
+  _mux->unlock();
+}
+
 }
 }
\ No newline at end of file
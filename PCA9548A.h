@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "BusStats.h"
+#include "Mutex.h"
 
 namespace ESPtools {
 namespace Mux {
@@ -10,18 +12,85 @@ namespace Mux {
 /**
  * PCA9548A 8-channel I2C multiplexer driver.
  * Allows switching between 8 downstream I2C buses.
+ *
+ * The control register is cached: selecting what is already enabled costs
+ * no I2C traffic. If something else may have written the mux (another
+ * driver instance, a mux reset), call invalidate() before the next select.
+ *
+ * channel(n) hands out a proxy for downstream bus n that drivers (ADS1115,
+ * PCF8575) can be constructed on instead of a TwoWire. Each access then
+ * locks the mux and switches to that bus only if another one is active,
+ * so device trees need no manual selectBus() calls and can be shared
+ * between FreeRTOS tasks.
+ *
+ * All PCA9548As on one TwoWire share a lock, and a channel access first
+ * disables whatever is open on the other muxes of that bus, so devices
+ * with the same address behind different muxes never answer together.
  */
 class PCA9548A {
 public:
+  /**
+   * One downstream bus. Obtained from PCA9548A::channel(); not copyable.
+   */
+  class Channel {
+  public:
+    TwoWire &wire() const { return _mux->_wire; }
+    PCA9548A &mux() const { return *_mux; }
+    uint8_t bus() const { return _bus; }
+
+    /**
+     * Lock the bus, close the channels of the other muxes on it and select
+     * this bus. Pair with release(); may nest.
+     */
+    void acquire();
+    void release();
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+  private:
+    friend class PCA9548A;
+    Channel() : _mux(nullptr), _bus(0) {}
+    PCA9548A *_mux;
+    uint8_t   _bus;
+  };
+
+  /**
+   * Holds a channel for one driver access. A nullptr channel (device on the
+   * main bus) does nothing, so drivers can use it unconditionally.
+   */
+  class Guard {
+  public:
+    explicit Guard(Channel *channel) : _channel(channel) {
+      if (_channel) _channel->acquire();
+    }
+    ~Guard() {
+      if (_channel) _channel->release();
+    }
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+  private:
+    Channel *_channel;
+  };
+
   /**
    * Constructor
    * @param address I2C address of PCA9548A (0x70-0x77)
    * @param wire    TwoWire instance (default Wire)
    */
   PCA9548A(uint8_t address = 0x70, TwoWire &wire = Wire);
+  ~PCA9548A();
+
+  PCA9548A(const PCA9548A &) = delete;
+  PCA9548A &operator=(const PCA9548A &) = delete;
+
+  // Muxes tracked for closing each other's channels (8 addresses per bus).
+  static constexpr uint8_t MAX_MUXES = 16;
 
   /**
-   * Initialize I2C bus for the multiplexer.
+   * Initialize I2C bus for the multiplexer and read back the control register.
    * @return true if device acknowledged
    */
   bool begin();
@@ -32,6 +101,13 @@ public:
    */
   void selectBus(uint8_t bus);
 
+  /**
+   * Enable any combination of downstream buses at once (bit0=bus0).
+   * Only safe when no address is present on more than one of them.
+   * @return false if the mux did not acknowledge
+   */
+  bool selectMask(uint8_t mask);
+
   /**
    * Disable all downstream buses.
    */
@@ -43,10 +119,48 @@ public:
    */
   uint8_t enabledMask() const;
 
+  /**
+   * Proxy for downstream bus 0-7.
+   */
+  Channel &channel(uint8_t bus) { return _channels[bus & 0x07]; }
+
+  /**
+   * BusStats route of a device behind a channel; MAIN_BUS for nullptr.
+   */
+  static uint8_t route(const Channel *channel) {
+    return channel ? BusStats::route(channel->_mux->_address, channel->_bus) : BusStats::MAIN_BUS;
+  }
+
+  /**
+   * Hold the mux so no other task can switch it (recursive). The lock is
+   * shared by every PCA9548A on the same TwoWire.
+   */
+  void lock() { _lock.lock(); }
+  void unlock() { _lock.unlock(); }
+
+  /**
+   * Forget the cached mask so the next select always writes the mux.
+   */
+  void invalidate() { _known = false; }
+
+  /**
+   * Control writes actually sent (cache misses).
+   */
+  uint32_t writeCount() const { return _writes; }
+
+  TwoWire &wire() const { return _wire; }
+  uint8_t address() const { return _address; }
+
 private:
   TwoWire &_wire;
   uint8_t _address;
   uint8_t _mask;
+  bool    _known;
+  uint32_t _writes;
+  Channel _channels[8];
+  Util::Mutex &_lock;
+
+  void closeOthers();
 };
 
 }
@@ -5,7 +5,14 @@ namespace IOExpander {
 namespace PCF8575 {
 
 PCF8575::PCF8575(uint8_t address, TwoWire &wire)
-  : _wire(wire), _address(address), _shadow(0xFFFF), _invertMask(0) {}
+  : _wire(wire), _channel(nullptr), _address(address), _shadow(0xFFFF), _invertMask(0),
+    _written(0xFFFF), _writtenKnown(false), _batchDepth(0), _intPin(-1), _dirty(false), _snapshot(0xFFFF), _changed(0), _rising(0), _falling(0) {}
+
+PCF8575::PCF8575(uint8_t address, Mux::PCA9548A::Channel &channel)
+  : _wire(channel.wire()), _channel(&channel), _address(address), _shadow(0xFFFF),
+    _invertMask(0), _written(0xFFFF), _writtenKnown(false), _batchDepth(0), _intPin(-1),
+    _dirty(false), _snapshot(0xFFFF), _changed(0), _rising(0),
+    _falling(0) {}
 
 bool PCF8575::begin() {
   _wire.begin();
@@ -14,13 +21,17 @@ bool PCF8575::begin() {
 }
 
 uint16_t PCF8575::readAll() {
+  if (_intPin >= 0) {
+    update();
+    return snapshot();
+  }
   uint16_t val = _readPort();
   return val ^ _invertMask;
 }
 
 void PCF8575::writeAll(uint16_t value) {
   _shadow = value;
-  _writePort(value ^ _invertMask);
+  _flush();
 }
 
 bool PCF8575::digitalRead(uint8_t pin) {
@@ -57,20 +68,79 @@ void PCF8575::invert(uint16_t mask, bool invert) {
   if (invert)      _invertMask |= mask;
   else             _invertMask &= ~mask;
 
-  _writePort(_shadow ^ _invertMask);
+  _flush();
+}
+
+void PCF8575::beginBatch() {
+  ++_batchDepth;
+}
+
+bool PCF8575::commit() {
+  if (_batchDepth > 0 && --_batchDepth > 0) return true;
+  return _flush();
+}
+
+bool PCF8575::pending() const {
+  return !_writtenKnown || uint16_t(_shadow ^ _invertMask) != _written;
 }
 
-void PCF8575::_writePort(uint16_t port) {
+uint8_t PCF8575::commitAll(PCF8575 *const *expanders, uint8_t count) {
+  // Main-bus expanders first, then by mux address and downstream bus; the
+  // mux selection cache turns each group into a single select. Each pass
+  // takes the smallest (key, index) after the previous one, so any count
+  // works without bookkeeping.
+  uint32_t last = 0;
+  uint8_t failed = 0;
+  for (uint8_t n = 0; n < count; ++n) {
+    int16_t next = -1;
+    uint32_t best = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+      const Mux::PCA9548A::Channel *ch = expanders[i]->_channel;
+      uint32_t key = ch ? uint32_t(((ch->mux().address() << 3) | ch->bus()) + 1) : 0;
+      uint32_t order = (key << 8) | i;
+      if (n > 0 && order <= last) continue;
+      if (next < 0 || order < best) {
+        next = i;
+        best = order;
+      }
+    }
+    last = best;
+    PCF8575 *e = expanders[next];
+    e->_batchDepth = 0;
+    if (!e->_flush()) ++failed;
+  }
+  return failed;
+}
+
+bool PCF8575::_flush() {
+  if (_batchDepth > 0) return true;
+  uint16_t port = _shadow ^ _invertMask;
+  if (_writtenKnown && port == _written) return true;
+  // After a NACK the device state is unknown, so the next flush rewrites.
+  _writtenKnown = _writePort(port);
+  if (_writtenKnown) _written = port;
+  return _writtenKnown;
+}
+
+bool PCF8575::_writePort(uint16_t port) {
   uint8_t lo = port & 0xFF;
   uint8_t hi = port >> 8;
+  Mux::PCA9548A::Guard guard(_channel);
+  BusStats::Probe probe(BusStats::I2C, _address, Mux::PCA9548A::route(_channel));
   _wire.beginTransmission(_address);
   _wire.write(lo);
   _wire.write(hi);
-  _wire.endTransmission();
+  bool ok = _wire.endTransmission() == 0;
+  probe.transaction(2, ok);
+  // A write also clears INT on the device, so a pending change would be lost.
+  if (_intPin >= 0) _dirty = true;
+  return ok;
 }
 
 uint16_t PCF8575::_readPort() {
-  _wire.requestFrom(int(_address), 2);
+  Mux::PCA9548A::Guard guard(_channel);
+  BusStats::Probe probe(BusStats::I2C, _address, Mux::PCA9548A::route(_channel));
+  probe.transaction(2, _wire.requestFrom(int(_address), 2) == 2);
   uint8_t lo = _wire.read();
   uint8_t hi = _wire.read();
   return (uint16_t)hi << 8 | lo;
@@ -81,6 +151,64 @@ void PCF8575::onInterrupt(uint8_t irqPin, void (*handler)(), int mode) {
   ::attachInterrupt(digitalPinToInterrupt(irqPin), handler, mode);
 }
 
+bool PCF8575::enableInputCache(uint8_t intPin) {
+  disableInputCache();
+  ::pinMode(intPin, INPUT_PULLUP);
+  _snapshot = _readPort();
+  _changed = _rising = _falling = 0;
+  _dirty = false;
+  _intPin = intPin;
+  ::attachInterruptArg(digitalPinToInterrupt(intPin), onPortInterrupt, this, FALLING);
+  return true;
+}
+
+void PCF8575::disableInputCache() {
+  if (_intPin < 0) return;
+  ::detachInterrupt(digitalPinToInterrupt(_intPin));
+  _intPin = -1;
+}
+
+bool PCF8575::update() {
+  if (_intPin < 0) return false;
+  // INT stays low until the port is read, so the level also catches a missed edge.
+  if (!_dirty && ::digitalRead(_intPin) != LOW) return false;
+  _dirty = false;
+
+  uint16_t before = _snapshot ^ _invertMask;
+  _snapshot = _readPort();
+  uint16_t after = _snapshot ^ _invertMask;
+  uint16_t diff = before ^ after;
+  if (!diff) return false;
+
+  _changed |= diff;
+  _rising  |= diff & after;
+  _falling |= diff & before;
+  if (_changeHandler) _changeHandler(after, diff);
+  return true;
+}
+
+uint16_t PCF8575::takeChanged() {
+  uint16_t v = _changed;
+  _changed = 0;
+  return v;
+}
+
+uint16_t PCF8575::takeRising() {
+  uint16_t v = _rising;
+  _rising = 0;
+  return v;
+}
+
+uint16_t PCF8575::takeFalling() {
+  uint16_t v = _falling;
+  _falling = 0;
+  return v;
+}
+
+void IRAM_ATTR PCF8575::onPortInterrupt(void *arg) {
+  static_cast<PCF8575 *>(arg)->_dirty = true;
+}
+
 }
 }
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <functional>
+#include "BusStats.h"
+#include "PCA9548A.h"
 
 namespace ESPtools {
 namespace IOExpander {
@@ -13,9 +16,41 @@ enum class PinMode { Input, Output };
 
 /**
  * PCF8575 16-bit I/O expander driver (instance-based, supports multiple devices).
+ *
+ * With enableInputCache() the INT line marks the port dirty and reads are
+ * served from a 16-bit snapshot; the bus is only read again after INT
+ * fires (or after a write, which also clears INT on the device). Changes
+ * between snapshots are accumulated as change/rising/falling masks.
+ *
+ * Output changes only reach the bus when the port value actually differs
+ * from what was last written. Between beginBatch() and commit() (or inside
+ * a Batch scope) they are collected in the shadow register and flushed as
+ * a single write.
  */
 class PCF8575 {
 public:
+  /**
+   * Called from update() when the snapshot changes.
+   * @param state   new port state (after inversion)
+   * @param changed bits that differ from the previous snapshot
+   */
+  using ChangeHandler = std::function<void(uint16_t state, uint16_t changed)>;
+
+  /**
+   * Scoped batch: beginBatch() on construction, commit() on destruction.
+   */
+  class Batch {
+  public:
+    explicit Batch(PCF8575 &expander) : _expander(expander) { _expander.beginBatch(); }
+    ~Batch() { _expander.commit(); }
+
+    Batch(const Batch &) = delete;
+    Batch &operator=(const Batch &) = delete;
+
+  private:
+    PCF8575 &_expander;
+  };
+
   /**
    * Constructor
    * @param address I2C address of PCF8575 (e.g., 0x20-0x27)
@@ -23,6 +58,14 @@ public:
    */
   PCF8575(uint8_t address, TwoWire &wire = Wire);
 
+  /**
+   * Constructor for a device behind a PCA9548A; the mux is switched
+   * automatically on every access.
+   * @param address I2C address of PCF8575
+   * @param channel downstream bus proxy from PCA9548A::channel()
+   */
+  PCF8575(uint8_t address, Mux::PCA9548A::Channel &channel);
+
   /**
    * Initialize I2C and read initial port state into shadow register.
    */
@@ -73,6 +116,30 @@ public:
    * Invert polarity on specified mask bits for read/write operations.
    */
   void invert(uint16_t mask, bool invert = true);
+
+  /**
+   * Hold output writes until the matching commit(). Batches may nest.
+   */
+  void beginBatch();
+
+  /**
+   * End a batch; the outermost commit writes the port once, if it changed.
+   * @return false if that write was not acknowledged (the next flush retries)
+   */
+  bool commit();
+
+  /**
+   * True if the shadow holds changes not yet written to the device.
+   */
+  bool pending() const;
+
+  /**
+   * Commit several expanders in one burst, ordered by mux channel so each
+   * downstream bus is selected at most once. Closes any open batch on each;
+   * unchanged expanders are skipped.
+   * @return number of expanders whose write was not acknowledged
+   */
+  static uint8_t commitAll(PCF8575 *const *expanders, uint8_t count);
   
   /**
    * Attach interrupt handler to INT line.
@@ -82,14 +149,75 @@ public:
    */
   void onInterrupt(uint8_t irqPin, void (*handler)(), int mode);
 
+  /**
+   * Serve reads from a snapshot refreshed only when INT signals a change.
+   * Takes the initial snapshot.
+   * @param intPin GPIO connected to PCF8575 INT (open drain, active low)
+   */
+  bool enableInputCache(uint8_t intPin);
+
+  /**
+   * Stop using the snapshot; reads go to the bus again.
+   */
+  void disableInputCache();
+
+  bool inputCacheEnabled() const { return _intPin >= 0; }
+
+  /**
+   * Refresh the snapshot if INT fired since the last read. Cheap when
+   * nothing changed (one GPIO read). Call from loop() or a task.
+   * @return true if the port state changed
+   */
+  bool update();
+
+  /**
+   * Current snapshot (after inversion) without touching the bus.
+   */
+  uint16_t snapshot() const { return _snapshot ^ _invertMask; }
+
+  /**
+   * Bits that changed since the last call (accumulated over updates).
+   */
+  uint16_t takeChanged();
+
+  /**
+   * Bits that went low-to-high / high-to-low since the last call.
+   */
+  uint16_t takeRising();
+  uint16_t takeFalling();
+
+  /**
+   * Handler for snapshot changes, called from update().
+   */
+  void onChange(ChangeHandler handler) { _changeHandler = handler; }
+
 private:
   TwoWire &_wire;
+  Mux::PCA9548A::Channel *_channel;
   uint8_t  _address;
   uint16_t _shadow;
   uint16_t _invertMask;
+  uint16_t _written;
+  bool     _writtenKnown;
+  uint8_t  _batchDepth;
+
+  // Input cache
+  int8_t   _intPin;
+  volatile bool _dirty;
+  uint16_t _snapshot;
+  uint16_t _changed;
+  uint16_t _rising;
+  uint16_t _falling;
+  ChangeHandler _changeHandler;
+
+  static void onPortInterrupt(void *arg);
+
+  // Write the shadow if it differs from the device and no batch is open;
+  // false only if a write was attempted and failed
+  bool _flush();
 
   // Perform raw I2C read or write
-  void _writePort(uint16_t port);
+  bool _writePort(uint16_t port);
   uint16_t _readPort();
 };
 
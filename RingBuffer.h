@@ -0,0 +1,91 @@
+#ifndef ESPTOOLS_RINGBUFFER_H
+#define ESPTOOLS_RINGBUFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+namespace ESPtools {
+namespace Util {
+
+/**
+ * Lock-free single-producer/single-consumer ring buffer.
+ * The producer may run in interrupt context; push() never blocks.
+ * Capacity N must be a power of two; all N slots are usable.
+ */
+template <typename T, size_t N>
+class RingBuffer {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+public:
+  RingBuffer() : _head(0), _tail(0) {}
+
+  /**
+   * Producer side: append one element.
+   * @return false if the buffer is full (element dropped)
+   */
+  bool push(const T &value) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t tail = _tail.load(std::memory_order_acquire);
+    if (head - tail >= N) return false;
+    _buf[head & (N - 1)] = value;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consumer side: remove one element.
+   * @return false if the buffer is empty
+   */
+  bool pop(T &value) {
+    return read(&value, 1) == 1;
+  }
+
+  /**
+   * Consumer side: drain up to maxCount elements into dst.
+   * @return number of elements copied
+   */
+  size_t read(T *dst, size_t maxCount) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t head = _head.load(std::memory_order_acquire);
+    size_t count = head - tail;
+    if (count > maxCount) count = maxCount;
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = _buf[(tail + i) & (N - 1)];
+    }
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * Number of elements waiting to be read.
+   */
+  size_t available() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Free slots left for the producer.
+   */
+  size_t space() const {
+    return N - (_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire));
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+  /**
+   * Discard all contents. Only safe while the producer is stopped.
+   */
+  void clear() {
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  T _buf[N];
+  std::atomic<uint32_t> _head;
+  std::atomic<uint32_t> _tail;
+};
+
+}
+}
+
+#endif
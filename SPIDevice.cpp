@@ -0,0 +1,68 @@
+#include "SPIDevice.h"
+
+namespace ESPtools {
+namespace Util {
+
+constexpr uint8_t SPIBus::MAX_BUSES;
+
+SPIBus *SPIBus::of(SPIClass &spi) {
+  static SPIBus buses[MAX_BUSES];
+  static Mutex registry;
+  Lock lock(registry);
+  for (uint8_t i = 0; i < MAX_BUSES; ++i) {
+    if (buses[i]._spi == &spi) return &buses[i];
+  }
+  for (uint8_t i = 0; i < MAX_BUSES; ++i) {
+    if (!buses[i]._spi) {
+      buses[i]._spi = &spi;
+      return &buses[i];
+    }
+  }
+  return nullptr;
+}
+
+SPIDevice::SPIDevice(SPIClass &spi, int8_t csPin, const SPISettings &settings)
+  : _spi(spi), _bus(SPIBus::of(spi)), _csPin(csPin), _settings(settings), _depth(0) {}
+
+bool SPIDevice::begin() {
+  pinMode(_csPin, OUTPUT);
+  digitalWrite(_csPin, HIGH);
+  return _bus != nullptr;
+}
+
+// The bus mutex is recursive and taken at every level, so _depth is only
+// touched by the task that holds it.
+void SPIDevice::beginBurst() {
+  if (_bus) _bus->lock();
+  if (_depth++ == 0) _spi.beginTransaction(_settings);
+}
+
+void SPIDevice::endBurst() {
+  if (_depth == 0) return;
+  if (--_depth == 0) _spi.endTransaction();
+  if (_bus) _bus->unlock();
+}
+
+void SPIDevice::select() {
+  beginBurst();
+  digitalWrite(_csPin, LOW);
+}
+
+void SPIDevice::deselect() {
+  digitalWrite(_csPin, HIGH);
+  endBurst();
+}
+
+void SPIDevice::transferBytes(const uint8_t *tx, uint8_t *rx, uint32_t size) {
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+  _spi.transferBytes(tx, rx, size);
+#else
+  for (uint32_t i = 0; i < size; ++i) {
+    uint8_t r = _spi.transfer(tx ? tx[i] : 0xFF);
+    if (rx) rx[i] = r;
+  }
+#endif
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef ESPTOOLS_SPI_DEVICE_H
+#define ESPTOOLS_SPI_DEVICE_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "Mutex.h"
+
+namespace ESPtools {
+namespace Util {
+
+/**
+ * Arbitration for one SPIClass shared by several devices and tasks.
+ * All SPIDevice objects on the same SPIClass share one SPIBus.
+ */
+class SPIBus {
+public:
+  static constexpr uint8_t MAX_BUSES = 4;
+
+  /**
+   * The SPIBus for an SPIClass, created on first use.
+   * @return nullptr if MAX_BUSES different SPIClass objects are registered
+   */
+  static SPIBus *of(SPIClass &spi);
+
+  SPIClass &spi() const { return *_spi; }
+  void lock()   { _mutex.lock(); }
+  void unlock() { _mutex.unlock(); }
+
+  SPIBus() : _spi(nullptr) {}
+  SPIBus(const SPIBus &) = delete;
+  SPIBus &operator=(const SPIBus &) = delete;
+
+private:
+  SPIClass *_spi;
+  Mutex     _mutex;
+};
+
+/**
+ * One chip on a shared SPI bus: CS pin plus SPISettings built once.
+ *
+ * select()/deselect() frame one CS window and claim the bus around it. A
+ * burst (beginBurst()/endBurst() or the scoped Burst) keeps the bus locked
+ * and the transaction open across several CS windows, so back-to-back
+ * commands pay for arbitration and beginTransaction() once. Bursts nest.
+ * Do not open a burst of another device on the same bus inside one.
+ */
+class SPIDevice {
+public:
+  /**
+   * @param spi      SPI bus
+   * @param csPin    chip select (active LOW)
+   * @param settings clock, bit order and mode for this chip
+   */
+  SPIDevice(SPIClass &spi, int8_t csPin, const SPISettings &settings);
+
+  /**
+   * Configure CS as an output, deasserted.
+   * @return false if no SPIBus was available (see SPIBus::MAX_BUSES); the
+   *         device then works without bus arbitration
+   */
+  bool begin();
+
+  /**
+   * Replace the settings; takes effect at the next burst or CS window.
+   */
+  void setSettings(const SPISettings &settings) { _settings = settings; }
+
+  /**
+   * Lock the bus and begin the transaction (outermost call only).
+   */
+  void beginBurst();
+
+  /**
+   * End one burst level; releases the bus after the outermost one.
+   */
+  void endBurst();
+
+  /**
+   * Assert CS, opening a burst if none is active.
+   */
+  void select();
+
+  /**
+   * Deassert CS and close the burst opened by select().
+   */
+  void deselect();
+
+  uint8_t transfer(uint8_t data) { return _spi.transfer(data); }
+
+  /**
+   * Full-duplex block transfer in one driver call.
+   * @param tx   bytes to send (may equal rx)
+   * @param rx   receives the bytes clocked in, or nullptr
+   * @param size number of bytes
+   */
+  void transferBytes(const uint8_t *tx, uint8_t *rx, uint32_t size);
+
+  /**
+   * Send a block, discarding what is clocked in.
+   */
+  void write(const uint8_t *data, uint32_t size) { transferBytes(data, nullptr, size); }
+
+  SPIClass &spi() const { return _spi; }
+  SPIBus *bus() const { return _bus; }
+  int8_t csPin() const { return _csPin; }
+
+  /**
+   * Holds a burst for the lifetime of the object.
+   */
+  class Burst {
+  public:
+    explicit Burst(SPIDevice &device) : _device(device) { _device.beginBurst(); }
+    ~Burst() { _device.endBurst(); }
+
+    Burst(const Burst &) = delete;
+    Burst &operator=(const Burst &) = delete;
+
+  private:
+    SPIDevice &_device;
+  };
+
+private:
+  SPIClass    &_spi;
+  SPIBus      *_bus;
+  int8_t       _csPin;
+  SPISettings  _settings;
+  uint8_t      _depth;
+};
+
+}
+}
+
+#endif
@@ -5,11 +5,15 @@ namespace ESPtools {
 namespace UART {
 
 static HardwareSerial* uartPort = nullptr;
-static String inputBuffer;
+static char lineBuffer[MAX_LINE];
+static size_t lineLength = 0;
+static bool overflow = false;
 
 void begin(HardwareSerial& port, uint32_t baud) {
   uartPort = &port;
   uartPort->begin(baud);
+  lineLength = 0;
+  overflow = false;
 }
 
 void loop() {
@@ -17,18 +21,21 @@ void loop() {
   while (uartPort->available()) {
     char c = uartPort->read();
     if (c == '\n') {
-      if (inputBuffer.endsWith("\r")) {
-        inputBuffer.remove(inputBuffer.length() - 1);
+      if (lineLength > 0 && lineBuffer[lineLength - 1] == '\r') --lineLength;
+      const char* sep = static_cast<const char*>(memchr(lineBuffer, ':', lineLength));
+      if (!overflow && sep && sep > lineBuffer) {
+        size_t topicLength = size_t(sep - lineBuffer);
+        // Topic and payload are published as views into the line buffer.
+        EventBus::publish(EventBus::View(lineBuffer, topicLength),
+                          EventBus::View(sep + 1, lineLength - topicLength - 1));
       }
-      int sep = inputBuffer.indexOf(':');
-      if (sep > 0) {
-        String topic = inputBuffer.substring(0, sep);
-        String payload = inputBuffer.substring(sep + 1);
-        EventBus::publish(topic, payload);
-      }
-      inputBuffer = "";
+      lineLength = 0;
+      overflow = false;
+    } else if (lineLength < MAX_LINE) {
+      lineBuffer[lineLength++] = c;
     } else {
-      inputBuffer += c;
+      // Over-long lines are dropped whole rather than split.
+      overflow = true;
     }
   }
 }
@@ -8,6 +8,9 @@
 namespace ESPtools {
 namespace UART {
 
+// Longest "topic:payload" line accepted; longer lines are dropped
+constexpr size_t MAX_LINE = 256;
+
 // Initialize UART bridge on given port and baud rate
 void begin(HardwareSerial& port, uint32_t baud);
 
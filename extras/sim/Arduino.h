@@ -0,0 +1,161 @@
+#ifndef ESPTOOLS_SIM_ARDUINO_H
+#define ESPTOOLS_SIM_ARDUINO_H
+
+// Host stand-in for the Arduino core. Time, GPIO and interrupts are routed
+// through the simulation kernel in SimCore.h so driver code runs unmodified.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "SimCore.h"
+
+#define IRAM_ATTR
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+
+static constexpr uint8_t LOW  = 0;
+static constexpr uint8_t HIGH = 1;
+
+static constexpr uint8_t INPUT          = 0x01;
+static constexpr uint8_t OUTPUT         = 0x03;
+static constexpr uint8_t PULLUP         = 0x04;
+static constexpr uint8_t INPUT_PULLUP   = 0x05;
+static constexpr uint8_t PULLDOWN       = 0x08;
+static constexpr uint8_t INPUT_PULLDOWN = 0x09;
+
+static constexpr int RISING  = 0x01;
+static constexpr int FALLING = 0x02;
+static constexpr int CHANGE  = 0x03;
+
+static constexpr uint8_t MSBFIRST = 1;
+static constexpr uint8_t LSBFIRST = 0;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+/**
+ * Minimal Arduino String, backed by std::string.
+ */
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const char* s, size_t n) : _s(s, n) {}
+  String(const std::string& s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(int v) : _s(std::to_string(v)) {}
+  explicit String(unsigned int v) : _s(std::to_string(v)) {}
+  explicit String(long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long v) : _s(std::to_string(v)) {}
+  explicit String(long long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long long v) : _s(std::to_string(v)) {}
+  explicit String(double v, unsigned int decimals = 2) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", int(decimals), v);
+    _s = buf;
+  }
+
+  unsigned int length() const { return unsigned(_s.size()); }
+  bool isEmpty() const { return _s.empty(); }
+  const char* c_str() const { return _s.c_str(); }
+  void reserve(unsigned int n) { _s.reserve(n); }
+  char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* o) { _s += o; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  bool concat(const char* s, size_t n) { _s.append(s, n); return true; }
+
+  bool operator==(const String& o) const { return _s == o._s; }
+  bool operator==(const char* o) const { return _s == o; }
+  bool operator!=(const String& o) const { return _s != o._s; }
+  bool operator!=(const char* o) const { return _s != o; }
+  bool operator<(const String& o) const { return _s < o._s; }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t p = _s.find(c, from);
+    return p == std::string::npos ? -1 : int(p);
+  }
+  int indexOf(const String& s, unsigned int from = 0) const {
+    size_t p = _s.find(s._s, from);
+    return p == std::string::npos ? -1 : int(p);
+  }
+  String substring(unsigned int from) const {
+    return from >= _s.size() ? String() : String(_s.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (to > _s.size()) to = unsigned(_s.size());
+    return from >= to ? String() : String(_s.substr(from, to - from));
+  }
+  bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+  bool endsWith(const String& p) const {
+    return _s.size() >= p._s.size() &&
+           _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+  }
+  void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+  void remove(unsigned int index, unsigned int count) {
+    if (index < _s.size()) _s.erase(index, count);
+  }
+  long toInt() const { return std::strtol(_s.c_str(), nullptr, 10); }
+  float toFloat() const { return std::strtof(_s.c_str(), nullptr); }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+
+private:
+  std::string _s;
+};
+
+/**
+ * Serial port stand-in. Output goes to stdout; input is fed by the host.
+ */
+class HardwareSerial {
+public:
+  void begin(uint32_t) {}
+  int available() { return int(_rx.size() - _rxPos); }
+  int read() { return _rxPos < _rx.size() ? (unsigned char)_rx[_rxPos++] : -1; }
+  size_t write(uint8_t c) { std::fputc(c, stdout); return 1; }
+  size_t print(const char* s) { return size_t(std::fputs(s, stdout)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t println(const char* s = "") { print(s); return write('\n'); }
+  size_t println(const String& s) { return println(s.c_str()); }
+
+  // Host side: queue bytes to be returned by read().
+  void simFeed(const char* s) {
+    if (_rxPos == _rx.size()) { _rx.clear(); _rxPos = 0; }
+    _rx += s;
+  }
+
+private:
+  std::string _rx;
+  size_t      _rxPos = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef ESPTOOLS_SIM_PREFERENCES_H
+#define ESPTOOLS_SIM_PREFERENCES_H
+
+// Host stand-in for the ESP32 Preferences (NVS) library. Namespaces live in
+// process memory and deliberately survive sim::reset(), like flash across a
+// power cycle.
+
+#include "Arduino.h"
+#include <map>
+#include <vector>
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* = nullptr) {
+    _ns = &store()[name];
+    _readOnly = readOnly;
+    return true;
+  }
+  void end() { _ns = nullptr; }
+
+  bool clear() {
+    if (!_ns || _readOnly) return false;
+    _ns->clear();
+    return true;
+  }
+  bool remove(const char* key) {
+    if (!_ns || _readOnly) return false;
+    return _ns->erase(key) > 0;
+  }
+  bool isKey(const char* key) { return _ns && _ns->count(key); }
+
+  size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, 1); }
+  size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, 4); }
+  uint8_t getUChar(const char* key, uint8_t def = 0) { getBytes(key, &def, 1); return def; }
+  uint32_t getUInt(const char* key, uint32_t def = 0) { getBytes(key, &def, 4); return def; }
+
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    if (!_ns || _readOnly) return 0;
+    const uint8_t* p = static_cast<const uint8_t*>(value);
+    (*_ns)[key].assign(p, p + len);
+    return len;
+  }
+  size_t getBytesLength(const char* key) {
+    if (!_ns) return 0;
+    auto it = _ns->find(key);
+    return it == _ns->end() ? 0 : it->second.size();
+  }
+  size_t getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!_ns) return 0;
+    auto it = _ns->find(key);
+    if (it == _ns->end() || it->second.size() > maxLen) return 0;
+    std::memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+
+  // Host side: wipe all namespaces (a blank flash).
+  static void simErase() { store().clear(); }
+
+private:
+  using Namespace = std::map<std::string, std::vector<uint8_t>>;
+  Namespace* _ns = nullptr;
+  bool       _readOnly = false;
+
+  static std::map<std::string, Namespace>& store() {
+    static std::map<std::string, Namespace> s;
+    return s;
+  }
+};
+
+#endif
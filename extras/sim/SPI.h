@@ -0,0 +1,80 @@
+#ifndef ESPTOOLS_SIM_SPI_H
+#define ESPTOOLS_SIM_SPI_H
+
+#include "Arduino.h"
+#include <vector>
+
+static constexpr uint8_t SPI_MODE0 = 0;
+static constexpr uint8_t SPI_MODE1 = 1;
+static constexpr uint8_t SPI_MODE2 = 2;
+static constexpr uint8_t SPI_MODE3 = 3;
+
+namespace sim {
+
+/**
+ * SPI target model. A target takes part in a transfer while its CS pin is
+ * LOW; chipSelect() is called on every CS edge written by firmware.
+ */
+class SPIDevice {
+public:
+  explicit SPIDevice(uint8_t csPin);
+  virtual ~SPIDevice() {}
+
+  uint8_t csPin() const { return _cs; }
+  bool selected() const { return pinLevel(_cs) == 0; }
+
+  virtual uint8_t spiTransfer(uint8_t mosi) = 0;
+  virtual void    chipSelect(bool) {}
+
+private:
+  uint8_t _cs;
+};
+
+}
+
+class SPISettings {
+public:
+  SPISettings() : _clock(1000000), _bitOrder(MSBFIRST), _dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+    : _clock(clock), _bitOrder(bitOrder), _dataMode(dataMode) {}
+  uint32_t _clock;
+  uint8_t  _bitOrder;
+  uint8_t  _dataMode;
+};
+
+/**
+ * Host SPIClass routing bytes to the attached target whose CS is asserted.
+ */
+class SPIClass {
+public:
+  SPIClass() {}
+
+  void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+  void end() {}
+  void beginTransaction(SPISettings settings);
+  void endTransaction();
+  void setFrequency(uint32_t freq) { _clock = freq; }
+
+  uint8_t  transfer(uint8_t data);
+  uint16_t transfer16(uint16_t data);
+  void     transfer(void* data, uint32_t size);
+  void     transferBytes(const uint8_t* data, uint8_t* out, uint32_t size);
+  void     writeBytes(const uint8_t* data, uint32_t size);
+
+  // Host side: attach a model to this bus.
+  void simAttach(sim::SPIDevice& dev) { _devices.push_back(&dev); }
+  void simDetachAll() { _devices.clear(); }
+  bool simInTransaction() const { return _inTransaction; }
+
+private:
+  std::vector<sim::SPIDevice*> _devices;
+  uint32_t _clock = 1000000;
+  bool     _inTransaction = false;
+
+  uint8_t exchange(uint8_t mosi);
+  void    charge(uint32_t bytes, uint64_t overheadNs);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,93 @@
+#include "SimADS1115.h"
+
+namespace sim {
+
+static const uint16_t SPS[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+static const double   FSR[8] = { 6.144, 4.096, 2.048, 1.024, 0.512, 0.256, 0.256, 0.256 };
+
+ADS1115::ADS1115(uint8_t address, int alertPin)
+  : I2CDevice(address), _alertPin(alertPin) {
+  _regs[0] = 0x0000;
+  _regs[1] = 0x8583;
+  _regs[2] = 0x8000;
+  _regs[3] = 0x7FFF;
+  input = [](uint8_t mux) { return 0.1 * (mux + 1); };
+  if (_alertPin >= 0) drivePin(uint8_t(_alertPin), 1);
+}
+
+uint64_t ADS1115::periodNs() const {
+  return 1000000000ULL / SPS[(_regs[1] >> 5) & 0x07];
+}
+
+bool ADS1115::rdyMode() const {
+  return (_regs[2] & 0x8000) == 0 && (_regs[3] & 0x8000) && (_regs[1] & 0x0003) != 0x0003;
+}
+
+void ADS1115::setAlert(bool active) {
+  if (_alertPin < 0) return;
+  bool pol = _regs[1] & 0x0008;
+  drivePin(uint8_t(_alertPin), active == pol ? 1 : 0);
+}
+
+void ADS1115::startConversion() {
+  if (_event) cancel(_event);
+  _busy = true;
+  if (rdyMode()) setAlert(false);
+  _event = schedule(nowNs() + periodNs(), [this] { completeConversion(); });
+}
+
+void ADS1115::completeConversion() {
+  _event = 0;
+  _conversions++;
+  uint8_t mux = (_regs[1] >> 12) & 0x07;
+  double  fsr = FSR[(_regs[1] >> 9) & 0x07];
+  long code = lround(input(mux) / fsr * 32768.0);
+  if (code > 32767) code = 32767;
+  if (code < -32768) code = -32768;
+  _regs[0] = uint16_t(int16_t(code));
+
+  bool continuous = (_regs[1] & 0x0100) == 0;
+  if (continuous) {
+    if (rdyMode()) {
+      setAlert(true);
+      schedule(nowNs() + 8000, [this] { setAlert(false); });
+    }
+    _event = schedule(nowNs() + periodNs(), [this] { completeConversion(); });
+  } else {
+    _busy = false;
+    if (rdyMode()) setAlert(true);
+  }
+}
+
+bool ADS1115::i2cWrite(const uint8_t* data, size_t len) {
+  _pointer = data[0] & 0x03;
+  if (len < 3) return true;
+  uint16_t value = uint16_t(data[1] << 8) | data[2];
+  if (_pointer == 0) return true;
+  if (_pointer != 1) {
+    _regs[_pointer] = value;
+    return true;
+  }
+  bool wasContinuous = (_regs[1] & 0x0100) == 0;
+  _regs[1] = value & 0x7FFF;
+  bool continuous = (value & 0x0100) == 0;
+  if (continuous) {
+    startConversion();
+  } else if (value & 0x8000) {
+    startConversion();
+  } else if (wasContinuous) {
+    if (_event) cancel(_event);
+    _event = 0;
+    _busy = false;
+  }
+  return true;
+}
+
+size_t ADS1115::i2cRead(uint8_t* data, size_t len) {
+  uint16_t v = _regs[_pointer];
+  if (_pointer == 1) v = (v & 0x7FFF) | (_busy ? 0 : 0x8000);
+  for (size_t i = 0; i < len; ++i) data[i] = (i & 1) ? uint8_t(v) : uint8_t(v >> 8);
+  return len;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef ESPTOOLS_SIM_ADS1115_H
+#define ESPTOOLS_SIM_ADS1115_H
+
+#include "Wire.h"
+
+namespace sim {
+
+/**
+ * Register model of the ADS1115: pointer register, config with OS/MODE
+ * semantics, data-rate accurate conversion timing, and ALERT/RDY behaviour
+ * when Hi_thresh/Lo_thresh are programmed into conversion-ready mode.
+ */
+class ADS1115 : public I2CDevice {
+public:
+  /**
+   * @param address   I2C address (0x48-0x4B)
+   * @param alertPin  GPIO wired to ALERT/RDY, or -1
+   */
+  explicit ADS1115(uint8_t address = 0x48, int alertPin = -1);
+
+  // Analog input in volts for a 3-bit MUX code (Config bits [14:12]).
+  std::function<double(uint8_t mux)> input;
+
+  uint16_t reg(uint8_t r) const { return _regs[r & 3]; }
+  uint32_t conversions() const { return _conversions; }
+
+  bool   i2cWrite(const uint8_t* data, size_t len) override;
+  size_t i2cRead(uint8_t* data, size_t len) override;
+
+private:
+  uint16_t _regs[4];
+  uint8_t  _pointer = 0;
+  int      _alertPin;
+  bool     _busy = false;
+  uint32_t _event = 0;
+  uint32_t _conversions = 0;
+
+  uint64_t periodNs() const;
+  bool     rdyMode() const;
+  void     startConversion();
+  void     completeConversion();
+  void     setAlert(bool active);
+};
+
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include "SimADS1256.h"
+
+namespace sim {
+
+// Indexed by DRATE upper nibble; 0x?x codes outside the datasheet table
+// fall back to the rate of their nibble.
+static const double RATES[16] = {
+  2.5, 5, 10, 15, 25, 30, 50, 60, 100, 500, 1000, 2000, 3750, 7500, 15000, 30000
+};
+// Settling time after SYNC/WAKEUP (datasheet Table 13), ms.
+static const double SETTLE_MS[16] = {
+  400.18, 200.18, 100.18, 66.84, 40.18, 33.51, 20.18, 16.84,
+  10.18, 2.18, 1.18, 0.68, 0.44, 0.31, 0.25, 0.21
+};
+// SELFCAL duration at PGA 1 (datasheet Table 21), ms.
+static const double CAL_MS[16] = {
+  503.5, 254.0, 129.0, 87.0, 53.7, 45.0, 27.6, 23.3,
+  14.5, 3.3, 2.0, 1.3, 0.95, 0.75, 0.65, 0.6
+};
+
+double ADS1256::dataRate(uint8_t drate) { return RATES[drate >> 4]; }
+uint64_t ADS1256::settleNs(uint8_t drate) { return uint64_t(SETTLE_MS[drate >> 4] * 1e6); }
+uint64_t ADS1256::calibrationNs(uint8_t drate) { return uint64_t(CAL_MS[drate >> 4] * 1e6); }
+
+ADS1256::ADS1256(uint8_t csPin, uint8_t drdyPin, int rstPin, int syncPin)
+  : SPIDevice(csPin), _drdyPin(drdyPin) {
+  input = [](uint8_t mux) { return 0.1 * ((mux >> 4) + 1); };
+  defaults();
+  drivePin(_drdyPin, 1);
+  if (rstPin >= 0) {
+    onPinWrite(uint8_t(rstPin), [this](int level) {
+      if (level == 0) {
+        _inReset = true;
+        stop();
+        setDrdy(false);
+      } else if (_inReset) {
+        _inReset = false;
+        defaults();
+        start(settleNs(_regs[3]));
+      }
+    });
+  }
+  if (syncPin >= 0) {
+    onPinWrite(uint8_t(syncPin), [this](int level) {
+      if (level == 0) {
+        stop();
+        _halted = true;
+      } else if (_halted) {
+        _halted = false;
+        start(settleNs(_regs[3]));
+      }
+    });
+  }
+  start(settleNs(_regs[3]));
+}
+
+void ADS1256::defaults() {
+  static const uint8_t RESET_REGS[11] = {
+    0x30, 0x01, 0x20, 0xF0, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  };
+  memcpy(_regs, RESET_REGS, sizeof(_regs));
+  _rdatac = false;
+  _state = State::Command;
+}
+
+void ADS1256::setDrdy(bool ready) {
+  drivePin(_drdyPin, ready ? 0 : 1);
+  if (ready) _regs[0] &= ~0x01;
+  else       _regs[0] |= 0x01;
+}
+
+void ADS1256::stop() {
+  if (_event) cancel(_event);
+  _event = 0;
+}
+
+void ADS1256::start(uint64_t firstNs) {
+  stop();
+  _convMux = _regs[1];
+  _event = schedule(nowNs() + firstNs, [this] { complete(); });
+}
+
+void ADS1256::complete() {
+  _event = 0;
+  _conversions++;
+  static const double PGA[8] = { 1, 2, 4, 8, 16, 32, 64, 64 };
+  double code = input(_convMux) * PGA[_regs[2] & 0x07] / vref * 8388607.0;
+  if (code > 8388607.0) code = 8388607.0;
+  if (code < -8388608.0) code = -8388608.0;
+  _data = int32_t(lround(code));
+  _dataMux = _convMux;
+  _rdatacIdx = 0;
+  // Schedule before raising DRDY: an ISR reading the word must not skew
+  // the conversion clock.
+  _convMux = _regs[1];
+  uint64_t period = uint64_t(1e9 / dataRate(_regs[3]));
+  _event = schedule(nowNs() + period, [this] { complete(); });
+  // DRDY pulses high briefly before each update so every sample is an edge.
+  if (pinLevel(_drdyPin) == 0) setDrdy(false);
+  setDrdy(true);
+}
+
+void ADS1256::calibrate() {
+  _calibrations++;
+  stop();
+  setDrdy(false);
+  _event = schedule(nowNs() + calibrationNs(_regs[3]), [this] { complete(); });
+}
+
+void ADS1256::writeReg(uint8_t r, uint8_t v) {
+  if (r > 10) return;
+  if (r == 0) v = (v & 0x0E) | (_regs[0] & 0xF1);
+  bool changed = _regs[r] != v;
+  _regs[r] = v;
+  bool acal = _regs[0] & 0x04;
+  if (acal && changed && (r == 0 || r == 2 || r == 3)) calibrate();
+}
+
+void ADS1256::command(uint8_t cmd) {
+  if ((cmd & 0xF0) == 0x50) {
+    _regPtr = cmd & 0x0F;
+    _state = State::WregCount;
+    return;
+  }
+  if ((cmd & 0xF0) == 0x10) {
+    _regPtr = cmd & 0x0F;
+    _state = State::RregCount;
+    return;
+  }
+  switch (cmd) {
+    case 0x00:
+    case 0xFF:
+      if (_halted) {
+        _halted = false;
+        start(settleNs(_regs[3]));
+      }
+      break;
+    case 0x01:
+      _out[0] = uint8_t(_data >> 16);
+      _out[1] = uint8_t(_data >> 8);
+      _out[2] = uint8_t(_data);
+      _outLen = 3;
+      _outIdx = 0;
+      _outIsData = true;
+      _state = State::Output;
+      break;
+    case 0x03:
+      _rdatac = true;
+      // The first word is available immediately after the command.
+      _rdatacIdx = 0;
+      break;
+    case 0x0F:
+      _rdatac = false;
+      break;
+    case 0xF0: case 0xF1: case 0xF2: case 0xF3: case 0xF4:
+      calibrate();
+      break;
+    case 0xFC:
+      stop();
+      _halted = true;
+      setDrdy(false);
+      break;
+    case 0xFD:
+      stop();
+      _halted = true;
+      break;
+    case 0xFE:
+      defaults();
+      _halted = false;
+      setDrdy(false);
+      start(settleNs(_regs[3]));
+      break;
+    default:
+      break;
+  }
+}
+
+uint8_t ADS1256::spiTransfer(uint8_t mosi) {
+  if (_inReset) return 0xFF;
+
+  if (_rdatac) {
+    uint8_t r = 0;
+    if (_rdatacIdx < 3) {
+      r = uint8_t(_data >> (8 * (2 - _rdatacIdx)));
+      if (++_rdatacIdx == 3) setDrdy(false);
+    }
+    if (mosi == 0x0F) _rdatac = false;
+    else if (mosi == 0xFE) command(0xFE);
+    return r;
+  }
+
+  switch (_state) {
+    case State::Output: {
+      uint8_t r = _out[_outIdx++];
+      if (_outIdx >= _outLen) {
+        _state = State::Command;
+        if (_outIsData) setDrdy(false);
+      }
+      return r;
+    }
+    case State::WregCount:
+      _count = (mosi & 0x0F) + 1;
+      _state = State::WregData;
+      return 0;
+    case State::WregData:
+      writeReg(_regPtr++, mosi);
+      if (--_count == 0) _state = State::Command;
+      return 0;
+    case State::RregCount: {
+      uint8_t n = (mosi & 0x0F) + 1;
+      for (uint8_t i = 0; i < n; ++i) {
+        uint8_t r = uint8_t(_regPtr + i);
+        _out[i] = r <= 10 ? _regs[r] : 0;
+      }
+      _outLen = n;
+      _outIdx = 0;
+      _outIsData = false;
+      _state = State::Output;
+      return 0;
+    }
+    case State::Command:
+    default:
+      command(mosi);
+      return 0;
+  }
+}
+
+void ADS1256::chipSelect(bool selected) {
+  // Raising CS resets the serial interface mid-command.
+  if (!selected && _state != State::Command) _state = State::Command;
+}
+
+}
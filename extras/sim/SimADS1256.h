@@ -0,0 +1,66 @@
+#ifndef ESPTOOLS_SIM_ADS1256_H
+#define ESPTOOLS_SIM_ADS1256_H
+
+#include "SPI.h"
+
+namespace sim {
+
+/**
+ * Command-level model of the ADS1256: register file, RDATA/RDATAC/SDATAC,
+ * WREG/RREG, SYNC/WAKEUP/STANDBY, RESET (command and pin), self-calibration
+ * and DRDY timing taken from the datasheet settling and calibration tables.
+ * An optional SYNC/PDWN pin halts conversions while LOW.
+ */
+class ADS1256 : public SPIDevice {
+public:
+  ADS1256(uint8_t csPin, uint8_t drdyPin, int rstPin = -1, int syncPin = -1);
+
+  // Differential input in volts for a MUX register value (PSEL<<4 | NSEL).
+  std::function<double(uint8_t mux)> input;
+  double vref = 2.5;
+
+  uint8_t  reg(uint8_t r) const { return _regs[r & 0x0F]; }
+  uint32_t conversions() const { return _conversions; }
+  uint32_t calibrations() const { return _calibrations; }
+  bool     continuousRead() const { return _rdatac; }
+  uint8_t  lastConvertedMux() const { return _dataMux; }
+
+  uint8_t spiTransfer(uint8_t mosi) override;
+  void    chipSelect(bool selected) override;
+
+  static double dataRate(uint8_t drate);
+  static uint64_t settleNs(uint8_t drate);
+  static uint64_t calibrationNs(uint8_t drate);
+
+private:
+  enum class State { Command, WregCount, WregData, RregCount, Output };
+
+  uint8_t  _regs[11];
+  uint8_t  _drdyPin;
+  State    _state = State::Command;
+  uint8_t  _regPtr = 0, _count = 0;
+  uint8_t  _out[16];
+  uint8_t  _outLen = 0, _outIdx = 0;
+  bool     _outIsData = false;
+  bool     _rdatac = false;
+  bool     _halted = false;
+  bool     _inReset = false;
+  int32_t  _data = 0;
+  uint8_t  _dataMux = 0, _convMux = 0;
+  uint8_t  _rdatacIdx = 3;
+  uint32_t _event = 0;
+  uint32_t _conversions = 0, _calibrations = 0;
+
+  void defaults();
+  void setDrdy(bool ready);
+  void stop();
+  void start(uint64_t firstNs);
+  void complete();
+  void calibrate();
+  void command(uint8_t cmd);
+  void writeReg(uint8_t r, uint8_t v);
+};
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "Arduino.h"
+
+#include <map>
+#include <vector>
+
+namespace sim {
+
+struct Event { uint64_t at; uint32_t id; EventFn fn; };
+
+struct Isr { void (*fn)(void*); void* arg; int mode; };
+
+static uint64_t _now = 0;
+static uint32_t _nextId = 1;
+static bool     _dispatching = false;
+static std::multimap<uint64_t, Event> _events;
+static std::map<uint8_t, int> _levels;
+static std::map<uint8_t, Isr> _isrs;
+static std::map<uint8_t, std::vector<PinListener>> _listeners;
+static std::map<uint8_t, std::function<uint16_t()>> _analog;
+static BusCounters _i2c, _spi;
+static GpioCounters _gpio;
+static int _irqDisabled = 0;
+
+uint64_t nowNs() { return _now; }
+
+void advanceTo(uint64_t atNs) {
+  if (atNs < _now) return;
+  if (_dispatching) {
+    _now = atNs;
+    return;
+  }
+  while (!_events.empty() && _events.begin()->first <= atNs) {
+    auto it = _events.begin();
+    Event ev = std::move(it->second);
+    _events.erase(it);
+    if (ev.at > _now) _now = ev.at;
+    _dispatching = true;
+    ev.fn();
+    _dispatching = false;
+  }
+  if (atNs > _now) _now = atNs;
+}
+
+void advance(uint64_t ns) { advanceTo(_now + ns); }
+
+uint32_t schedule(uint64_t atNs, EventFn fn) {
+  uint32_t id = _nextId++;
+  _events.emplace(atNs, Event{ atNs, id, std::move(fn) });
+  return id;
+}
+
+void cancel(uint32_t id) {
+  for (auto it = _events.begin(); it != _events.end(); ++it) {
+    if (it->second.id == id) { _events.erase(it); return; }
+  }
+}
+
+void reset() {
+  _now = 0;
+  _events.clear();
+  _levels.clear();
+  _isrs.clear();
+  _listeners.clear();
+  _analog.clear();
+  _i2c = BusCounters();
+  _spi = BusCounters();
+  _gpio = GpioCounters();
+  _irqDisabled = 0;
+}
+
+int pinLevel(uint8_t pin) {
+  auto it = _levels.find(pin);
+  return it == _levels.end() ? 1 : it->second;
+}
+
+static void setLevel(uint8_t pin, int level) {
+  int old = pinLevel(pin);
+  _levels[pin] = level;
+  if (old == level) return;
+  auto it = _isrs.find(pin);
+  if (it == _isrs.end() || !it->second.fn || _irqDisabled) return;
+  int edge = level ? RISING : FALLING;
+  if (it->second.mode & edge) it->second.fn(it->second.arg);
+}
+
+void drivePin(uint8_t pin, int level) { setLevel(pin, level ? 1 : 0); }
+
+static void notifyWrite(uint8_t pin, int level) {
+  auto it = _listeners.find(pin);
+  if (it == _listeners.end()) return;
+  for (auto& fn : it->second) fn(level);
+}
+
+void firmwareWrite(uint8_t pin, int level) {
+  level = level ? 1 : 0;
+  setLevel(pin, level);
+  notifyWrite(pin, level);
+}
+
+// Each mask is one register write: all its pins change before anyone looks.
+static void writeRegister(uint64_t mask, int level) {
+  if (!mask) return;
+  _gpio.writes++;
+  for (uint8_t pin = 0; pin < 64; ++pin) {
+    if (mask & (uint64_t(1) << pin)) setLevel(pin, level);
+  }
+  for (uint8_t pin = 0; pin < 64; ++pin) {
+    if (mask & (uint64_t(1) << pin)) notifyWrite(pin, level);
+  }
+}
+
+void writePinMasks(uint64_t setMask, uint64_t clearMask) {
+  advance(GPIO_COST_NS);
+  writeRegister(setMask, 1);
+  writeRegister(clearMask & ~setMask, 0);
+}
+
+void onPinWrite(uint8_t pin, PinListener fn) { _listeners[pin].push_back(std::move(fn)); }
+
+void setAnalog(uint8_t pin, std::function<uint16_t()> fn) { _analog[pin] = std::move(fn); }
+
+uint16_t analogValue(uint8_t pin) {
+  auto it = _analog.find(pin);
+  return it == _analog.end() ? 0 : it->second();
+}
+
+void attachIsr(uint8_t pin, void (*fn)(void*), void* arg, int mode) {
+  _isrs[pin] = Isr{ fn, arg, mode };
+}
+
+void detachIsr(uint8_t pin) { _isrs.erase(pin); }
+
+void irqDisable() { ++_irqDisabled; }
+void irqEnable()  { if (_irqDisabled) --_irqDisabled; }
+
+BusCounters& i2cCounters() { return _i2c; }
+BusCounters& spiCounters() { return _spi; }
+GpioCounters& gpioCounters() { return _gpio; }
+
+}
+
+HardwareSerial Serial;
+
+static void (*_plainIsrs[64])() = {};
+
+static void plainTrampoline(void* arg) {
+  uintptr_t pin = reinterpret_cast<uintptr_t>(arg);
+  if (pin < 64 && _plainIsrs[pin]) _plainIsrs[pin]();
+}
+
+void pinMode(uint8_t, uint8_t) { sim::advance(sim::GPIO_COST_NS); }
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  sim::gpioCounters().writes++;
+  sim::advance(sim::GPIO_COST_NS);
+  sim::firmwareWrite(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+  sim::gpioCounters().reads++;
+  sim::advance(sim::GPIO_COST_NS);
+  return sim::pinLevel(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+  sim::advance(10000);
+  return sim::analogValue(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  if (pin < 64) _plainIsrs[pin] = handler;
+  sim::attachIsr(pin, plainTrampoline, reinterpret_cast<void*>(uintptr_t(pin)), mode);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  sim::attachIsr(pin, handler, arg, mode);
+}
+
+void detachInterrupt(uint8_t pin) { sim::detachIsr(pin); }
+
+namespace sim { void irqDisable(); void irqEnable(); }
+void noInterrupts() { sim::irqDisable(); }
+void interrupts()   { sim::irqEnable(); }
+
+unsigned long millis() {
+  sim::advance(sim::TIMER_COST_NS);
+  return (unsigned long)(sim::nowNs() / 1000000ULL);
+}
+
+unsigned long micros() {
+  sim::advance(sim::TIMER_COST_NS);
+  return (unsigned long)(sim::nowNs() / 1000ULL);
+}
+
+void delay(uint32_t ms) { sim::advance(uint64_t(ms) * 1000000ULL); }
+void delayMicroseconds(uint32_t us) { sim::advance(uint64_t(us) * 1000ULL); }
+void yield() { sim::advance(1000); }
@@ -0,0 +1,70 @@
+#ifndef ESPTOOLS_SIM_CORE_H
+#define ESPTOOLS_SIM_CORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/**
+ * Simulation kernel shared by the host backends and device models.
+ *
+ * Time is virtual: it only moves when driver code calls delay(), touches a
+ * pin or a bus, or when the host calls sim::advance(). Device models
+ * schedule events (conversion complete, DRDY edges) on the same timeline,
+ * and pin edges dispatch attached ISRs synchronously.
+ */
+namespace sim {
+
+// Cost charged for HAL calls, so busy-wait loops make progress.
+static constexpr uint64_t GPIO_COST_NS  = 100;
+static constexpr uint64_t TIMER_COST_NS = 50;
+
+uint64_t nowNs();
+void     advance(uint64_t ns);
+void     advanceTo(uint64_t atNs);
+
+using EventFn = std::function<void()>;
+uint32_t schedule(uint64_t atNs, EventFn fn);
+void     cancel(uint32_t id);
+
+/**
+ * Drop all scheduled events, pin state, listeners and counters.
+ * Device models must be re-attached afterwards.
+ */
+void reset();
+
+// GPIO: levels driven by firmware (digitalWrite) or by models (drivePin).
+int  pinLevel(uint8_t pin);
+void drivePin(uint8_t pin, int level);
+
+using PinListener = std::function<void(int level)>;
+void onPinWrite(uint8_t pin, PinListener fn);
+void setAnalog(uint8_t pin, std::function<uint16_t()> fn);
+
+// Called by the Arduino shim.
+void firmwareWrite(uint8_t pin, int level);
+// Register-style write of several pins at one instant (ESP32 W1TS/W1TC).
+void writePinMasks(uint64_t setMask, uint64_t clearMask);
+void attachIsr(uint8_t pin, void (*fn)(void*), void* arg, int mode);
+void detachIsr(uint8_t pin);
+uint16_t analogValue(uint8_t pin);
+
+struct BusCounters {
+  uint64_t transactions = 0;
+  uint64_t bytes        = 0;
+  uint64_t errors       = 0;
+  uint64_t busyNs       = 0;
+};
+
+struct GpioCounters {
+  uint64_t writes = 0;
+  uint64_t reads  = 0;
+};
+
+BusCounters&  i2cCounters();
+BusCounters&  spiCounters();
+GpioCounters& gpioCounters();
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef ESPTOOLS_SIM_PCA9548A_H
+#define ESPTOOLS_SIM_PCA9548A_H
+
+#include "Wire.h"
+
+namespace sim {
+
+/**
+ * PCA9548A model: one control register; downstream targets are visible on
+ * the upstream bus while their channel bit is set.
+ */
+class PCA9548A : public I2CDevice {
+public:
+  explicit PCA9548A(uint8_t address = 0x70) : I2CDevice(address) {}
+
+  void attach(uint8_t channel, I2CDevice& dev) { _down[channel & 7].push_back(&dev); }
+
+  uint8_t  control() const { return _control; }
+  uint32_t writes() const { return _writes; }
+
+  bool i2cWrite(const uint8_t* data, size_t len) override {
+    _control = data[len - 1];
+    _writes++;
+    return true;
+  }
+
+  size_t i2cRead(uint8_t* data, size_t len) override {
+    for (size_t i = 0; i < len; ++i) data[i] = _control;
+    return len;
+  }
+
+  void collect(uint8_t address, std::vector<I2CDevice*>& out) override {
+    I2CDevice::collect(address, out);
+    for (uint8_t ch = 0; ch < 8; ++ch) {
+      if (!(_control & (1 << ch))) continue;
+      for (auto* d : _down[ch]) d->collect(address, out);
+    }
+  }
+
+private:
+  uint8_t _control = 0;
+  uint32_t _writes = 0;
+  std::vector<I2CDevice*> _down[8];
+};
+
+}
+
+#endif
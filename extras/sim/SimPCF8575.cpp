@@ -0,0 +1,41 @@
+#include "SimPCF8575.h"
+
+namespace sim {
+
+PCF8575::PCF8575(uint8_t address, int intPin)
+  : I2CDevice(address), _intPin(intPin) {
+  setInt(false);
+}
+
+void PCF8575::setInt(bool active) {
+  if (_intPin >= 0) drivePin(uint8_t(_intPin), active ? 0 : 1);
+}
+
+void PCF8575::setInputs(uint16_t levels) {
+  _external = levels;
+  if (port() != _lastRead) setInt(true);
+}
+
+bool PCF8575::i2cWrite(const uint8_t* data, size_t len) {
+  // Bytes alternate P07..P00, P17..P10; the last complete pair wins.
+  for (size_t i = 0; i + 1 < len; i += 2) {
+    _latch = uint16_t(data[i + 1] << 8) | data[i];
+  }
+  if (len >= 2) {
+    _writes++;
+    _lastRead = port();
+    setInt(false);
+  }
+  return true;
+}
+
+size_t PCF8575::i2cRead(uint8_t* data, size_t len) {
+  uint16_t p = port();
+  for (size_t i = 0; i < len; ++i) data[i] = (i & 1) ? uint8_t(p >> 8) : uint8_t(p);
+  _reads++;
+  _lastRead = p;
+  setInt(false);
+  return len;
+}
+
+}
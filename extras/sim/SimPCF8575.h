@@ -0,0 +1,40 @@
+#ifndef ESPTOOLS_SIM_PCF8575_H
+#define ESPTOOLS_SIM_PCF8575_H
+
+#include "Wire.h"
+
+namespace sim {
+
+/**
+ * PCF8575 quasi-bidirectional port model. Reads return the output latch
+ * ANDed with externally driven levels; INT asserts on any input change
+ * and is released by a read or write of the port.
+ */
+class PCF8575 : public I2CDevice {
+public:
+  explicit PCF8575(uint8_t address = 0x20, int intPin = -1);
+
+  // Host side: levels driven onto the pins by the fixture (1 = released).
+  void setInputs(uint16_t levels);
+
+  uint16_t latch() const { return _latch; }
+  uint32_t writes() const { return _writes; }
+  uint32_t reads() const { return _reads; }
+
+  bool   i2cWrite(const uint8_t* data, size_t len) override;
+  size_t i2cRead(uint8_t* data, size_t len) override;
+
+private:
+  uint16_t _latch = 0xFFFF;
+  uint16_t _external = 0xFFFF;
+  uint16_t _lastRead = 0xFFFF;
+  int      _intPin;
+  uint32_t _writes = 0, _reads = 0;
+
+  uint16_t port() const { return _latch & _external; }
+  void setInt(bool active);
+};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "SPI.h"
+
+SPIClass SPI;
+
+// Software overhead of the ESP32 HAL, per call.
+static constexpr uint64_t SPI_BEGIN_NS    = 2000;
+static constexpr uint64_t SPI_END_NS      = 500;
+static constexpr uint64_t SPI_TRANSFER_NS = 1000;
+static constexpr uint64_t SPI_BLOCK_NS    = 1500;
+
+namespace sim {
+
+SPIDevice::SPIDevice(uint8_t csPin) : _cs(csPin) {
+  onPinWrite(csPin, [this](int level) {
+    if (level == 0) spiCounters().transactions++;
+    chipSelect(level == 0);
+  });
+}
+
+}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  _clock = settings._clock;
+  _inTransaction = true;
+  sim::advance(SPI_BEGIN_NS);
+}
+
+void SPIClass::endTransaction() {
+  _inTransaction = false;
+  sim::advance(SPI_END_NS);
+}
+
+void SPIClass::charge(uint32_t bytes, uint64_t overheadNs) {
+  uint64_t ns = uint64_t(bytes) * 8ULL * 1000000000ULL / _clock + overheadNs;
+  auto& c = sim::spiCounters();
+  c.bytes += bytes;
+  c.busyNs += ns;
+  sim::advance(ns);
+}
+
+uint8_t SPIClass::exchange(uint8_t mosi) {
+  uint8_t miso = 0xFF;
+  for (auto* d : _devices) {
+    if (d->selected()) miso &= d->spiTransfer(mosi);
+  }
+  return miso;
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  charge(1, SPI_TRANSFER_NS);
+  return exchange(data);
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+  charge(2, SPI_TRANSFER_NS);
+  uint16_t hi = exchange(uint8_t(data >> 8));
+  return uint16_t(hi << 8) | exchange(uint8_t(data));
+}
+
+void SPIClass::transfer(void* data, uint32_t size) {
+  transferBytes(static_cast<const uint8_t*>(data), static_cast<uint8_t*>(data), size);
+}
+
+void SPIClass::transferBytes(const uint8_t* data, uint8_t* out, uint32_t size) {
+  charge(size, SPI_BLOCK_NS);
+  for (uint32_t i = 0; i < size; ++i) {
+    uint8_t r = exchange(data ? data[i] : 0xFF);
+    if (out) out[i] = r;
+  }
+}
+
+void SPIClass::writeBytes(const uint8_t* data, uint32_t size) {
+  transferBytes(data, nullptr, size);
+}
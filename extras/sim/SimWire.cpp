@@ -0,0 +1,75 @@
+#include "Wire.h"
+
+TwoWire Wire;
+TwoWire Wire1;
+
+// Fixed software overhead of one Wire transaction on the ESP32 HAL.
+static constexpr uint64_t I2C_CALL_OVERHEAD_NS = 20000;
+
+std::vector<sim::I2CDevice*> TwoWire::route(uint8_t address) {
+  std::vector<sim::I2CDevice*> out;
+  for (auto* d : _devices) d->collect(address, out);
+  if (out.size() > 1) ++_collisions;
+  return out;
+}
+
+void TwoWire::charge(size_t bytes, bool ok) {
+  // START + address byte + payload, 9 clocks per byte, plus STOP.
+  uint64_t bits = 2 + 9 * (bytes + 1);
+  uint64_t ns = bits * 1000000000ULL / _clock + I2C_CALL_OVERHEAD_NS;
+  auto& c = sim::i2cCounters();
+  c.transactions++;
+  c.bytes += bytes + 1;
+  c.busyNs += ns;
+  if (!ok) c.errors++;
+  sim::advance(ns);
+}
+
+void TwoWire::beginTransmission(int address) {
+  _txAddress = uint8_t(address);
+  _tx.clear();
+}
+
+size_t TwoWire::write(uint8_t b) {
+  _tx.push_back(b);
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  _tx.insert(_tx.end(), data, data + len);
+  return len;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  auto targets = route(_txAddress);
+  if (targets.empty()) {
+    charge(0, false);
+    return 2;
+  }
+  bool ack = true;
+  for (auto* d : targets) {
+    if (!_tx.empty() && !d->i2cWrite(_tx.data(), _tx.size())) ack = false;
+  }
+  charge(_tx.size(), ack);
+  return ack ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity, int) {
+  _rx.assign(size_t(quantity), 0xFF);
+  _rxPos = 0;
+  auto targets = route(uint8_t(address));
+  if (targets.empty() || quantity <= 0) {
+    _rx.clear();
+    charge(0, false);
+    return 0;
+  }
+  // Open-drain bus: colliding targets AND their data together.
+  std::vector<uint8_t> tmp(_rx.size());
+  for (auto* d : targets) {
+    std::fill(tmp.begin(), tmp.end(), 0xFF);
+    d->i2cRead(tmp.data(), tmp.size());
+    for (size_t i = 0; i < tmp.size(); ++i) _rx[i] &= tmp[i];
+  }
+  charge(_rx.size(), true);
+  return uint8_t(_rx.size());
+}
@@ -0,0 +1,77 @@
+#ifndef ESPTOOLS_SIM_WIRE_H
+#define ESPTOOLS_SIM_WIRE_H
+
+#include "Arduino.h"
+#include <vector>
+
+namespace sim {
+
+/**
+ * I2C target model. Muxes expose their enabled downstream targets through
+ * collect() so the bus can route transactions through them.
+ */
+class I2CDevice {
+public:
+  explicit I2CDevice(uint8_t address) : _address(address) {}
+  virtual ~I2CDevice() {}
+
+  uint8_t address() const { return _address; }
+
+  // Return false to NACK a data byte.
+  virtual bool   i2cWrite(const uint8_t* data, size_t len) = 0;
+  virtual size_t i2cRead(uint8_t* data, size_t len) = 0;
+
+  virtual void collect(uint8_t address, std::vector<I2CDevice*>& out) {
+    if (address == _address) out.push_back(this);
+  }
+
+private:
+  uint8_t _address;
+};
+
+}
+
+/**
+ * Host TwoWire routing transactions to attached sim::I2CDevice models.
+ * Bus time is charged per bit at the configured clock.
+ */
+class TwoWire {
+public:
+  TwoWire() {}
+
+  bool begin() { return true; }
+  bool begin(int, int, uint32_t freq = 0) { if (freq) _clock = freq; return true; }
+  void setClock(uint32_t freq) { _clock = freq; }
+  uint32_t getClock() const { return _clock; }
+
+  void    beginTransmission(int address);
+  size_t  write(uint8_t b);
+  size_t  write(const uint8_t* data, size_t len);
+  uint8_t endTransmission(bool sendStop = true);
+
+  uint8_t requestFrom(int address, int quantity, int sendStop = 1);
+  int available() { return int(_rx.size() - _rxPos); }
+  int read() { return _rxPos < _rx.size() ? _rx[_rxPos++] : -1; }
+  int peek() { return _rxPos < _rx.size() ? _rx[_rxPos] : -1; }
+
+  // Host side: attach a model to this bus.
+  void simAttach(sim::I2CDevice& dev) { _devices.push_back(&dev); }
+  void simDetachAll() { _devices.clear(); }
+  uint64_t simCollisions() const { return _collisions; }
+
+private:
+  std::vector<sim::I2CDevice*> _devices;
+  std::vector<uint8_t> _tx, _rx;
+  size_t   _rxPos = 0;
+  uint8_t  _txAddress = 0;
+  uint32_t _clock = 100000;
+  uint64_t _collisions = 0;
+
+  std::vector<sim::I2CDevice*> route(uint8_t address);
+  void charge(size_t bytes, bool ok);
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif
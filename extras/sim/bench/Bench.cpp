@@ -0,0 +1,704 @@
+// Driver benchmarks on the host simulation backend.
+//
+// Every case runs the real driver code against the device models and
+// reports, per operation: simulated time, I2C/SPI transactions and bytes,
+// and GPIO writes. Pass a substring to run only matching cases:
+//
+//   ./bench ads1115
+//
+// Numbers are only as good as the cost model in SimWire.cpp/SimSPI.cpp,
+// so compare cases against each other rather than against hardware.
+// Pure-CPU cases (EventBus) have no bus cost and report host wall time.
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include "ADS1115.h"
+#include "ADS1115Group.h"
+#include "ADS1115Scanner.h"
+#include "ADS1256.h"
+#include "ADS1256Group.h"
+#include "BusStats.h"
+#include "CD74HC4067.h"
+#include "ChannelMatrix.h"
+#include "EventBus.h"
+#include "EventChannel.h"
+#include "I2CScheduler.h"
+#include "I2CTopology.h"
+#include "PCA9548A.h"
+#include "PCF8575.h"
+#include "UARTBridge.h"
+
+#include "SimADS1115.h"
+#include "SimADS1256.h"
+#include "SimPCA9548A.h"
+#include "SimPCF8575.h"
+#include "Preferences.h"
+
+using namespace ESPtools;
+using ADC::ADS1115;
+using ADC::ADS1256;
+
+static const char *filter = nullptr;
+
+static bool selected(const char *name) {
+  return !filter || std::strstr(name, filter) != nullptr;
+}
+
+/**
+ * Run fn, which performs `ops` operations, and print per-operation cost.
+ */
+template <typename Fn>
+static void bench(const char *name, uint32_t ops, Fn fn) {
+  if (!selected(name)) return;
+  sim::BusCounters  i2c0 = sim::i2cCounters();
+  sim::BusCounters  spi0 = sim::spiCounters();
+  sim::GpioCounters io0  = sim::gpioCounters();
+  uint64_t t0 = sim::nowNs();
+
+  fn();
+
+  double n = ops ? ops : 1;
+  const sim::BusCounters  &i2c = sim::i2cCounters();
+  const sim::BusCounters  &spi = sim::spiCounters();
+  const sim::GpioCounters &io  = sim::gpioCounters();
+  std::printf("%-40s %10.1f %7.2f %7.1f %7.2f %7.1f %7.1f\n", name,
+              (sim::nowNs() - t0) / 1000.0 / n,
+              (i2c.transactions - i2c0.transactions) / n,
+              (i2c.bytes - i2c0.bytes) / n,
+              (spi.transactions - spi0.transactions) / n,
+              (spi.bytes - spi0.bytes) / n,
+              (io.writes - io0.writes) / n);
+}
+
+// Heap allocations made by the whole program, for benchHost().
+static uint64_t heapAllocs = 0;
+
+void *operator new(size_t size) {
+  ++heapAllocs;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+/**
+ * Run fn, which performs `ops` operations, and print host time and heap
+ * allocations per operation. For code that never touches a simulated bus.
+ */
+template <typename Fn>
+static void benchHost(const char *name, uint32_t ops, Fn fn) {
+  if (!selected(name)) return;
+  uint64_t allocs0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  double n = ops ? ops : 1;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%-40s %10.3f   (host, %.2f allocs)\n", name, ns / 1000.0 / n,
+              (heapAllocs - allocs0) / n);
+}
+
+// With -DESPTOOLS_BUS_STATS=1, print what the drivers' own probes recorded.
+static void printBusStats() {
+#if ESPTOOLS_BUS_STATS
+  BusStats::DeviceStats d;
+  for (uint8_t i = 0; BusStats::device(i, d); ++i) {
+    char route[16] = "";
+    if (d.route != BusStats::MAIN_BUS) {
+      std::snprintf(route, sizeof(route), " @0x%02x.%u", 0x70 | ((d.route >> 3) & 0x07),
+                    d.route & 0x07);
+    }
+    std::printf("  %s 0x%02x%s %s\n", d.bus == BusStats::I2C ? "i2c" : "spi", d.address,
+                route, BusStats::toJSON(d).c_str());
+  }
+#endif
+}
+
+static void fresh() {
+  printBusStats();
+  sim::reset();
+  Wire.simDetachAll();
+  Wire.setClock(400000);
+  SPI.simDetachAll();
+  BusStats::reset();
+}
+
+static void benchADS1115() {
+  static const uint32_t N = 200;
+  for (int pin = -1; pin <= 17; pin += 18) {
+    fresh();
+    sim::ADS1115 chip(0x48, pin);
+    Wire.simAttach(chip);
+    ADS1115 adc(Wire, 0x48, pin);
+    adc.begin();
+    adc.setSampleRate(ADS1115::SPS_860);
+
+    bench(pin < 0 ? "ads1115/read (OS poll)" : "ads1115/read (ALERT/RDY)", N, [&] {
+      for (uint32_t i = 0; i < N; ++i) adc.read(1);
+    });
+    bench(pin < 0 ? "ads1115/read 4 inputs (OS poll)" : "ads1115/read 4 inputs (ALERT/RDY)", N, [&] {
+      for (uint32_t i = 0; i < N; ++i) adc.readVoltage(i & 3, 1);
+    });
+
+    ADC::ADS1115Scanner scanner(adc);
+    for (uint8_t ch = 0; ch < 4; ++ch) scanner.addInput(ADS1115::singleEnded(ch), ADS1115::GAIN_1X);
+    bench(pin < 0 ? "ads1115/scanner 4 inputs (OS poll)" : "ads1115/scanner 4 inputs (ALERT/RDY)", N, [&] {
+      ADC::ADS1115Reading r;
+      uint32_t got = 0;
+      scanner.start();
+      while (got < N) {
+        scanner.poll();
+        while (scanner.read(r)) ++got;
+        delayMicroseconds(20);
+      }
+      scanner.stop();
+    });
+  }
+
+  fresh();
+  sim::PCA9548A mux(0x70);
+  sim::ADS1115 c0(0x48, 16), c1(0x49, 17), c2(0x48, 18), c3(0x48, 19);
+  Wire.simAttach(mux);
+  mux.attach(0, c0);
+  mux.attach(0, c1);
+  mux.attach(1, c2);
+  mux.attach(2, c3);
+  Mux::PCA9548A i2cMux(0x70, Wire);
+  i2cMux.begin();
+  ADS1115 a0(Wire, 0x48, 16), a1(Wire, 0x49, 17), a2(Wire, 0x48, 18), a3(Wire, 0x48, 19);
+  ADS1115 *adcs[4] = { &a0, &a1, &a2, &a3 };
+  const uint8_t buses[4] = { 0, 0, 1, 2 };
+  ADC::ADS1115Group group;
+  for (uint8_t d = 0; d < 4; ++d) {
+    i2cMux.selectBus(buses[d]);
+    adcs[d]->begin();
+    adcs[d]->setSampleRate(ADS1115::SPS_860);
+    group.addDevice(*adcs[d], &i2cMux, buses[d]);
+    for (uint8_t ch = 0; ch < 4; ++ch) group.addInput(d, ADS1115::singleEnded(ch), ADS1115::GAIN_1X);
+  }
+  bench("ads1115/4 devices sequential, per reading", 16 * 10, [&] {
+    for (int sweep = 0; sweep < 10; ++sweep) {
+      for (uint8_t d = 0; d < 4; ++d) {
+        i2cMux.selectBus(buses[d]);
+        for (uint8_t ch = 0; ch < 4; ++ch) adcs[d]->readVoltage(ch, 1);
+      }
+    }
+  });
+  bench("ads1115/4 devices group, per reading", 16 * 10, [&] {
+    for (int sweep = 0; sweep < 10; ++sweep) group.sample();
+  });
+}
+
+static void benchADS1256() {
+  fresh();
+  sim::ADS1256 chip(5, 4, 6);
+  SPI.simAttach(chip);
+  ADS1256 adc(SPI, 5, 4, 6);
+  adc.begin();
+  adc.setSampleRate(ADS1256::SPS_30000);
+  adc.setChannel(0);
+
+  bench("ads1256/read same channel", 100, [&] {
+    for (int i = 0; i < 100; ++i) adc.read(1);
+  });
+  bench("ads1256/readVoltage 8 channels", 80, [&] {
+    for (int i = 0; i < 80; ++i) adc.readVoltage(i & 7, 1);
+  });
+
+  uint8_t list[8];
+  for (uint8_t ch = 0; ch < 8; ++ch) list[ch] = ADS1256::singleEnded(ch);
+  int32_t codes[8];
+  bench("ads1256/scan 8 channels, per reading", 8 * 20, [&] {
+    for (int i = 0; i < 20; ++i) adc.scan(list, 8, codes);
+  });
+
+  bench("ads1256/setGain unchanged", 100, [&] {
+    for (int i = 0; i < 100; ++i) adc.setGain(ADS1256::GAIN_1X);
+  });
+  bench("ads1256/setGain alternating", 100, [&] {
+    for (int i = 0; i < 100; ++i) adc.setGain((i & 1) ? ADS1256::GAIN_2X : ADS1256::GAIN_1X);
+  });
+  bench("ads1256/readID + 4 registers, per command", 5 * 20, [&] {
+    for (int i = 0; i < 20; ++i) {
+      adc.readID();
+      for (uint8_t r = 0; r < 4; ++r) adc.readRegister(r);
+    }
+  });
+  bench("ads1256/readID + 4 registers, burst", 5 * 20, [&] {
+    for (int i = 0; i < 20; ++i) {
+      Util::SPIDevice::Burst burst(adc.spiDevice());
+      adc.readID();
+      for (uint8_t r = 0; r < 4; ++r) adc.readRegister(r);
+    }
+  });
+
+  adc.setChannel(0);
+  int32_t block[256];
+  uint32_t samples = 0;
+  bench("ads1256/streaming, per sample", 3000, [&] {
+    adc.startStreaming();
+    while (samples < 3000) {
+      delay(1);
+      samples += adc.readBlock(block, 256);
+    }
+    adc.stopStreaming();
+  });
+}
+
+static void benchADS1256Startup() {
+  fresh();
+  sim::ADS1256 c0(5, 4, 6), c1(15, 14, 16), c2(25, 24, 26), c3(35, 34, 36);
+  SPI.simAttach(c0);
+  SPI.simAttach(c1);
+  SPI.simAttach(c2);
+  SPI.simAttach(c3);
+  ADS1256 a0(SPI, 5, 4, 6), a1(SPI, 15, 14, 16), a2(SPI, 25, 24, 26), a3(SPI, 35, 34, 36);
+  ADS1256 *adcs[4] = { &a0, &a1, &a2, &a3 };
+
+  bench("ads1256/begin, per device", 4, [&] {
+    for (uint8_t i = 0; i < 4; ++i) adcs[i]->begin();
+  });
+  bench("ads1256/beginAll 4 devices, per device", 4, [&] {
+    ADS1256::beginAll(adcs, 4);
+  });
+}
+
+static void benchADS1256Group() {
+  fresh();
+  sim::ADS1256 chip0(5, 4, 6, 13), chip1(15, 14, 16, 13);
+  SPI.simAttach(chip0);
+  SPI.simAttach(chip1);
+  ADS1256 adc0(SPI, 5, 4, 6), adc1(SPI, 15, 14, 16);
+  adc0.begin();
+  adc1.begin();
+  adc0.setSampleRate(ADS1256::SPS_7500);
+  adc1.setSampleRate(ADS1256::SPS_7500);
+  adc0.setChannel(0);
+  adc1.setChannel(0);
+
+  bench("ads1256group/2 ADCs in turn, per pair", 50, [&] {
+    for (int i = 0; i < 50; ++i) {
+      adc0.read(1);
+      adc1.read(1);
+    }
+  });
+
+  ADC::ADS1256Group group;
+  group.addDevice(adc0, ADS1256::singleEnded(0), ADS1256::GAIN_1X);
+  group.addDevice(adc1, ADS1256::singleEnded(0), ADS1256::GAIN_1X);
+  int32_t frames[2 * 50];
+  bench("ads1256group/2 ADCs, SYNC cmd, per frame", 50, [&] {
+    group.start();
+    group.capture(frames, 50);
+  });
+  group.setSyncPin(13);
+  bench("ads1256group/2 ADCs, SYNC pin, per frame", 50, [&] {
+    group.start();
+    group.capture(frames, 50);
+  });
+}
+
+static void benchPCF8575() {
+  fresh();
+  sim::PCF8575 chip(0x20);
+  Wire.simAttach(chip);
+  IOExpander::PCF8575::PCF8575 io(0x20, Wire);
+  io.begin();
+
+  bench("pcf8575/digitalRead", 100, [&] {
+    for (int i = 0; i < 100; ++i) io.digitalRead(i & 15);
+  });
+  bench("pcf8575/readAll", 100, [&] {
+    for (int i = 0; i < 100; ++i) io.readAll();
+  });
+  bench("pcf8575/digitalWrite", 100, [&] {
+    for (int i = 0; i < 100; ++i) io.digitalWrite(i & 7, i & 1);
+  });
+
+  bench("pcf8575/10-pin relay pattern, digitalWrite", 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      for (uint8_t pin = 0; pin < 10; ++pin) io.digitalWrite(pin, (pin + i) & 1);
+    }
+  });
+  bench("pcf8575/10-pin relay pattern, batch", 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      IOExpander::PCF8575::PCF8575::Batch batch(io);
+      for (uint8_t pin = 0; pin < 10; ++pin) io.digitalWrite(pin, (pin + i) & 1);
+    }
+  });
+  bench("pcf8575/unchanged writeMask", 100, [&] {
+    for (int i = 0; i < 100; ++i) io.writeMask(0x00FF, 0x0055);
+  });
+
+  fresh();
+  sim::PCA9548A muxChip(0x70);
+  Wire.simAttach(muxChip);
+  sim::PCF8575 *relayChips[4];
+  for (uint8_t k = 0; k < 4; ++k) {
+    relayChips[k] = new sim::PCF8575(0x20);
+    muxChip.attach(k, *relayChips[k]);
+  }
+  Mux::PCA9548A mux(0x70, Wire);
+  mux.begin();
+  IOExpander::PCF8575::PCF8575 r0(0x20, mux.channel(2)), r1(0x20, mux.channel(0)),
+                               r2(0x20, mux.channel(3)), r3(0x20, mux.channel(1));
+  IOExpander::PCF8575::PCF8575 *relays[4] = { &r0, &r1, &r2, &r3 };
+  bench("pcf8575/4 muxed expanders, commitAll", 4 * 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      for (uint8_t k = 0; k < 4; ++k) {
+        relays[k]->beginBatch();
+        relays[k]->writeMask(0x03FF, uint16_t(0x155 << (i & 1)));
+      }
+      IOExpander::PCF8575::PCF8575::commitAll(relays, 4);
+    }
+  });
+  for (uint8_t k = 0; k < 4; ++k) delete relayChips[k];
+
+  fresh();
+  sim::PCF8575 irqChip(0x20, 25);
+  Wire.simAttach(irqChip);
+  IOExpander::PCF8575::PCF8575 cached(0x20, Wire);
+  cached.begin();
+  cached.enableInputCache(25);
+  bench("pcf8575/cached 16-pin poll, idle", 100, [&] {
+    for (int i = 0; i < 100; ++i) {
+      for (uint8_t pin = 0; pin < 16; ++pin) cached.digitalRead(pin);
+    }
+  });
+  bench("pcf8575/cached 16-pin poll, 1 change/10", 100, [&] {
+    for (int i = 0; i < 100; ++i) {
+      if (i % 10 == 0) irqChip.setInputs(uint16_t(0xFFFF ^ (1u << (i / 10))));
+      for (uint8_t pin = 0; pin < 16; ++pin) cached.digitalRead(pin);
+    }
+  });
+}
+
+static void benchPCA9548A() {
+  fresh();
+  sim::PCA9548A chip(0x70);
+  Wire.simAttach(chip);
+  Mux::PCA9548A mux(0x70, Wire);
+  mux.begin();
+
+  bench("pca9548a/selectBus same bus", 100, [&] {
+    for (int i = 0; i < 100; ++i) mux.selectBus(3);
+  });
+  bench("pca9548a/selectBus round robin", 100, [&] {
+    for (int i = 0; i < 100; ++i) mux.selectBus(i & 7);
+  });
+}
+
+// Eight PCF8575s, one per mux channel, polled with a 2-byte read each.
+static void benchI2CScheduler(bool distinct) {
+  fresh();
+  sim::PCA9548A chip(0x70);
+  Wire.simAttach(chip);
+  sim::PCF8575 *ios[8];
+  for (uint8_t ch = 0; ch < 8; ++ch) {
+    ios[ch] = new sim::PCF8575(distinct ? 0x20 + ch : 0x20);
+    chip.attach(ch, *ios[ch]);
+  }
+  Mux::PCA9548A mux(0x70, Wire);
+  mux.begin();
+  Mux::I2CScheduler sched(Wire);
+  int8_t dev[8];
+  for (uint8_t ch = 0; ch < 8; ++ch) dev[ch] = sched.addDevice(distinct ? 0x20 + ch : 0x20, &mux, ch);
+  uint8_t data[8][2];
+
+  bench(distinct ? "i2c/8 ch distinct addr, selectBus+read" : "i2c/8 ch same addr, selectBus+read", 80, [&] {
+    for (int sweep = 0; sweep < 10; ++sweep) {
+      for (uint8_t ch = 0; ch < 8; ++ch) {
+        mux.selectBus(ch);
+        Wire.requestFrom(distinct ? 0x20 + ch : 0x20, 2);
+        data[ch][0] = Wire.read();
+        data[ch][1] = Wire.read();
+      }
+    }
+  });
+  bench(distinct ? "i2c/8 ch distinct addr, scheduler" : "i2c/8 ch same addr, scheduler", 80, [&] {
+    for (int sweep = 0; sweep < 10; ++sweep) {
+      for (uint8_t ch = 0; ch < 8; ++ch) sched.writeRead(dev[ch], nullptr, 0, 2, data[ch]);
+      sched.run();
+    }
+  });
+  for (uint8_t ch = 0; ch < 8; ++ch) delete ios[ch];
+}
+
+// Two PCF8575s at the same address on two mux channels, driven through proxies.
+static void benchMuxChannels() {
+  fresh();
+  sim::PCA9548A chip(0x70);
+  sim::PCF8575 x(0x20), y(0x20);
+  Wire.simAttach(chip);
+  chip.attach(0, x);
+  chip.attach(1, y);
+  Mux::PCA9548A mux(0x70, Wire);
+  mux.begin();
+  IOExpander::PCF8575::PCF8575 a(0x20, mux.channel(0)), b(0x20, mux.channel(1));
+  a.begin();
+  b.begin();
+
+  bench("pca9548a/channel proxy, 4 ops per device", 80, [&] {
+    for (int i = 0; i < 10; ++i) {
+      for (int k = 0; k < 4; ++k) a.digitalWrite(k, i & 1);
+      for (int k = 0; k < 4; ++k) b.digitalRead(k);
+    }
+  });
+}
+
+static void benchCD74HC4067() {
+  fresh();
+  Mux::CD74HC4067 mux(14, 12, 13, 15, -1);
+  mux.begin();
+
+  bench("cd74hc4067/selectChannel sequential", 160, [&] {
+    for (int i = 0; i < 160; ++i) mux.selectChannel(i & 15);
+  });
+  bench("cd74hc4067/select + readAnalog", 160, [&] {
+    for (int i = 0; i < 160; ++i) {
+      mux.selectChannel(i & 15);
+      mux.readAnalog(36);
+    }
+  });
+
+  uint16_t values[Mux::CD74HC4067::CHANNELS];
+  bench("cd74hc4067/scanAll sequential", 160, [&] {
+    for (int i = 0; i < 10; ++i) mux.scanAll(36, values);
+  });
+  mux.setScanOrder(Mux::CD74HC4067::ScanOrder::Gray);
+  bench("cd74hc4067/scanAll gray", 160, [&] {
+    for (int i = 0; i < 10; ++i) mux.scanAll(36, values);
+  });
+  mux.setSettleTime(5);
+  bench("cd74hc4067/scanAll gray, 5us settle, 4x", 160, [&] {
+    for (int i = 0; i < 10; ++i) mux.scanAll(36, values, 4);
+  });
+}
+
+// Fixture: two CD74HC4067 on ADS1115 AIN0/AIN1, a third on ADS1256 AIN0,
+// 20 us mux settle time, 16 channels each.
+static void benchChannelMatrix() {
+  fresh();
+  sim::ADS1115 chip(0x48, 33);
+  Wire.simAttach(chip);
+  sim::ADS1256 bigChip(5, 4, 6);
+  SPI.simAttach(bigChip);
+  Mux::CD74HC4067 muxA(14, 12, 13, 15), muxB(25, 26, 27, 32), muxC(16, 17, 18, 19);
+  Mux::CD74HC4067 *muxes[3] = { &muxA, &muxB, &muxC };
+  for (Mux::CD74HC4067 *m : muxes) {
+    m->begin();
+    m->setSettleTime(20);
+  }
+  ADS1115 adc(Wire, 0x48, 33);
+  adc.begin();
+  adc.setSampleRate(ADS1115::SPS_860);
+  ADS1256 big(SPI, 5, 4, 6);
+  big.begin();
+  big.setSampleRate(ADS1256::SPS_7500);
+
+  bench("matrix/48 points, hand-written loop", 48 * 5, [&] {
+    for (int sweep = 0; sweep < 5; ++sweep) {
+      for (uint8_t ch = 0; ch < 16; ++ch) {
+        muxA.selectChannel(ch);
+        delayMicroseconds(20);
+        adc.readVoltage(0, 1);
+        muxB.selectChannel(ch);
+        delayMicroseconds(20);
+        adc.readVoltage(1, 1);
+        muxC.selectChannel(ch);
+        delayMicroseconds(20);
+        big.startConversion(ADS1256::singleEnded(0), ADS1256::GAIN_1X);
+        big.read(1);
+      }
+    }
+  });
+
+  ADC::ChannelMatrix matrix;
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    matrix.addPoint(muxA, ch, adc, ADS1115::singleEnded(0), ADS1115::GAIN_1X);
+    matrix.addPoint(muxB, ch, adc, ADS1115::singleEnded(1), ADS1115::GAIN_1X);
+    matrix.addPoint(muxC, ch, big, ADS1256::singleEnded(0), ADS1256::GAIN_1X);
+  }
+  bench("matrix/48 points, ChannelMatrix", 48 * 5, [&] {
+    for (int sweep = 0; sweep < 5; ++sweep) matrix.sample();
+  });
+}
+
+// Two PCA9548As with nine devices between them and the main bus. Each case
+// is one boot; NVS contents survive fresh() like flash survives a reset.
+static void benchTopology() {
+  const char *names[3] = { "topology/boot, channel-by-channel scan",
+                           "topology/boot, 8 channels in parallel",
+                           "topology/boot, cached map verified" };
+  Preferences::simErase();
+  for (int boot = 0; boot < 3; ++boot) {
+    fresh();
+    sim::PCA9548A m0(0x70), m1(0x71);
+    sim::ADS1115 a0(0x48), a1(0x48), a2(0x49), a3(0x48), a4(0x4A);
+    sim::PCF8575 p0(0x20), p1(0x21), p2(0x20);
+    Wire.simAttach(m0);
+    Wire.simAttach(m1);
+    Wire.simAttach(p0);
+    m0.attach(0, a0);
+    m0.attach(3, a1);
+    m0.attach(3, a2);
+    m0.attach(7, p1);
+    m1.attach(2, a3);
+    m1.attach(5, p2);
+    m1.attach(6, a4);
+
+    Mux::PCA9548A mux0(0x70), mux1(0x71);
+    Mux::I2CTopology topology;
+    topology.addMux(mux0);
+    topology.addMux(mux1);
+    if (boot == 0) topology.setParallelChannels(1);
+    bench(names[boot], 1, [&] { topology.begin(); });
+    if (boot == 0) Preferences::simErase();
+  }
+}
+
+static void benchEventBus() {
+  static const uint32_t N = 200000;
+  static const uint16_t counts[2] = { 16, 120 };
+  static const char *names[2] = { "eventbus/publish, 16 topics subscribed",
+                                  "eventbus/publish, 120 topics subscribed" };
+  volatile uint32_t hits = 0;
+  auto count = [&](const EventBus::Message &) { hits = hits + 1; };
+  for (uint8_t c = 0; c < 2; ++c) {
+    EventBus::begin();
+    for (uint16_t i = 0; i < counts[c]; ++i) {
+      EventBus::subscribe(EventBus::topic("fixture/dev" + String(i) + "/temp"), count);
+    }
+    String topic = "fixture/dev" + String(counts[c] - 1) + "/temp";
+    String payload = "21.5";
+    benchHost(names[c], N, [&] {
+      for (uint32_t i = 0; i < N; ++i) EventBus::publish(topic, payload);
+    });
+  }
+
+  EventBus::subscribe("fixture/+/temp", count);
+  EventBus::subscribe("fixture/#", count);
+  String topic = "fixture/dev7/temp";
+  String payload = "21.5";
+  benchHost("eventbus/publish, 120 topics + 2 filters", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) EventBus::publish(topic, payload);
+  });
+
+  EventBus::begin();
+  EventBus::subscribe(String("fixture/dev7/temp"), [&](const String &) { hits = hits + 1; });
+  benchHost("eventbus/publish, String handler", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) EventBus::publish(topic, payload);
+  });
+
+  EventBus::begin();
+  EventBus::TopicId id = EventBus::topic("fixture/dev7/temp");
+  EventBus::subscribe(id, count);
+  benchHost("eventbus/publish, String API", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) EventBus::publish(topic, payload);
+  });
+  benchHost("eventbus/publish, TopicId + view", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) EventBus::publish(id, EventBus::View("21.5", 4));
+  });
+
+  benchHost("eventbus/post + loop, per message", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) {
+      EventBus::post(id, EventBus::View("21.5", 4));
+      if (EventBus::pending() == EventBus::QUEUE_DEPTH) EventBus::loop();
+    }
+    EventBus::loop();
+  });
+  EventBus::setPriority(id, EventBus::Priority::Telemetry);
+  EventBus::setLane(EventBus::Priority::Telemetry, 8, EventBus::Overflow::Coalesce);
+  benchHost("eventbus/post + loop, coalescing lane", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) {
+      EventBus::post(id, EventBus::View("21.5", 4));
+      if (EventBus::pending() == EventBus::QUEUE_DEPTH) EventBus::loop();
+    }
+    EventBus::loop();
+  });
+  EventBus::setPriority(id, EventBus::Priority::Normal);
+  benchHost("eventbus/post, dispatcher thread", N, [&] {
+    EventBus::startDispatcher();
+    for (uint32_t i = 0; i < N; ++i) {
+      while (!EventBus::post(id, EventBus::View("21.5", 4))) std::this_thread::yield();
+    }
+    while (EventBus::pending()) std::this_thread::yield();
+    EventBus::stopDispatcher();
+  });
+
+  static const uint32_t LINES = 20000;
+  UART::begin(Serial, 115200);
+  benchHost("eventbus/UART bridge line", LINES, [&] {
+    for (uint32_t i = 0; i < LINES; ++i) {
+      Serial.simFeed("fixture/dev7/temp:21.5\r\n");
+      UART::loop();
+    }
+  });
+  EventBus::begin();
+}
+
+struct BenchSample {
+  uint32_t micros;
+  uint8_t  channel;
+  int32_t  code;
+  float    volts;
+};
+ESPTOOLS_CHANNEL(BenchChannel, BenchSample, "fixture/adc");
+
+static void benchEventChannel() {
+  static const uint32_t N = 200000;
+  volatile float sum = 0;
+  EventBus::begin();
+  EventBus::subscribe(EventBus::topic("fixture/adc"), [&](const EventBus::Message &m) {
+    sum = sum + strtof(m.payload.toString().c_str(), nullptr);
+  });
+  benchHost("channel/String format + parse", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) EventBus::publish("fixture/adc", String(i * 0.001f, 6));
+  });
+
+  EventBus::begin();
+  BenchChannel::subscribe([&](const BenchSample &s) { sum = sum + s.volts; });
+  BenchSample sample = { 0, 3, 0, 0 };
+  benchHost("channel/publish struct", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) {
+      sample.volts = i * 0.001f;
+      BenchChannel::publish(sample);
+    }
+  });
+  benchHost("channel/post struct + loop", N, [&] {
+    for (uint32_t i = 0; i < N; ++i) {
+      sample.volts = i * 0.001f;
+      BenchChannel::post(sample);
+      if (EventBus::pending() == EventBus::QUEUE_DEPTH) EventBus::loop();
+    }
+    EventBus::loop();
+  });
+  EventBus::begin();
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) filter = argv[1];
+  std::printf("%-40s %10s %7s %7s %7s %7s %7s\n", "case (per op)",
+              "us", "i2c tx", "i2c B", "spi tx", "spi B", "gpio w");
+  benchADS1115();
+  benchADS1256();
+  benchADS1256Startup();
+  benchADS1256Group();
+  benchPCF8575();
+  benchPCA9548A();
+  benchI2CScheduler(true);
+  benchI2CScheduler(false);
+  benchMuxChannels();
+  benchTopology();
+  benchCD74HC4067();
+  benchChannelMatrix();
+
+  benchEventBus();
+  benchEventChannel();
+
+  printBusStats();
+  return 0;
+}